@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath> // pow()
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <Eigen/Dense>
+
+#include <cppmath/optimization/DownhillSimplexMethod.hpp>
+#include <cppmath/optimization/DownhillSimplexMethodNM.hpp>
+
+/**
+ * Performance suite for the simplex methods on standard test functions for dimensions 2 to 100.
+ * Reports evaluations and iterations to convergence, wall time and the overhead per iteration,
+ * i.e. the time not spent in the objective.
+ *
+ * Usage: DownhillSimplexBenchmark [filter], e.g. "Rosenbrock" or "NM" to run only matching benchmarks.
+ */
+
+typedef cppmath::DownhillSimplexMethod< Eigen::Dynamic > LagariasT;
+typedef cppmath::DownhillSimplexMethodNM< Eigen::Dynamic > NelderMeadT;
+typedef Eigen::VectorXd ParamsT;
+
+/**
+ * Sphere function, f(0, ..., 0) = 0
+ */
+template< typename BASE >
+class Sphere: public BASE
+{
+public:
+    explicit Sphere( size_t dimension ) :
+                    BASE( dimension )
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const
+    {
+        return x.squaredNorm();
+    }
+
+    static ParamsT initial( size_t dimension )
+    {
+        // Not symmetric, otherwise the initial simplex could have equal function values.
+        return ParamsT::LinSpaced( dimension, 1.0, dimension );
+    }
+};
+
+/**
+ * Generalized Rosenbrock function, f(1, ..., 1) = 0
+ */
+template< typename BASE >
+class Rosenbrock: public BASE
+{
+public:
+    explicit Rosenbrock( size_t dimension ) :
+                    BASE( dimension )
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const
+    {
+        double f = 0.0;
+        for( ParamsT::Index i = 0; i + 1 < x.size(); ++i )
+        {
+            f += 100.0 * pow( x( i + 1 ) - x( i ) * x( i ), 2 ) + pow( 1.0 - x( i ), 2 );
+        }
+        return f;
+    }
+
+    static ParamsT initial( size_t dimension )
+    {
+        ParamsT x( dimension );
+        for( size_t i = 0; i < dimension; ++i )
+        {
+            x( i ) = i % 2 ? 1.0 : -1.2;
+        }
+        return x;
+    }
+};
+
+/**
+ * Beale's function, f(3, 0.5) = 0, only 2 dimensions.
+ */
+template< typename BASE >
+class Beale: public BASE
+{
+public:
+    explicit Beale( size_t dimension ) :
+                    BASE( dimension )
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const
+    {
+        const double x1 = x( 0 );
+        const double x2 = x( 1 );
+        const double t1 = pow( 1.5 - x1 * ( 1 - x2 ), 2 );
+        const double t2 = pow( 2.25 - x1 * ( 1 - pow( x2, 2 ) ), 2 );
+        const double t3 = pow( 2.625 - x1 * ( 1 - pow( x2, 3 ) ), 2 );
+        return t1 + t2 + t3;
+    }
+
+    static ParamsT initial( size_t dimension )
+    {
+        return ParamsT::Ones( dimension );
+    }
+};
+
+/**
+ * Extended Powell's quartic function, f(0, ..., 0) = 0, dimension must be a multiple of 4.
+ */
+template< typename BASE >
+class Quartic: public BASE
+{
+public:
+    explicit Quartic( size_t dimension ) :
+                    BASE( dimension )
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const
+    {
+        double f = 0.0;
+        for( ParamsT::Index i = 0; i + 3 < x.size(); i += 4 )
+        {
+            f += pow( x( i ) + 10.0 * x( i + 1 ), 2 ) + 5.0 * pow( x( i + 2 ) - x( i + 3 ), 2 )
+                            + pow( x( i + 1 ) - 2 * x( i + 2 ), 4 ) + 10.0 * pow( x( i ) - x( i + 3 ), 4 );
+        }
+        return f;
+    }
+
+    static ParamsT initial( size_t dimension )
+    {
+        ParamsT x( dimension );
+        const double start[4] = { 3.0, -1.0, 0.0, 1.0 };
+        for( size_t i = 0; i < dimension; ++i )
+        {
+            x( i ) = start[i % 4];
+        }
+        return x;
+    }
+};
+
+template< template< typename > class FUNC, typename BASE >
+void run( const std::string& function, const std::string& method, size_t dimension, const std::string& filter )
+{
+    const std::string name = function + "/" + method + "/" + std::to_string( dimension );
+    if( !filter.empty() && name.find( filter ) == std::string::npos )
+    {
+        return;
+    }
+
+    FUNC< BASE > opt( dimension );
+    opt.setMaximumIterations( 500 * dimension );
+    opt.setEpsilon( 1e-10 );
+    opt.getConvergence().setFunctionSpread( 1e-14 );
+    const ParamsT initial = FUNC< BASE >::initial( dimension );
+
+    // Take the fastest of some repetitions to reduce noise.
+    const size_t repetitions = 5;
+    double wall = std::numeric_limits< double >::max();
+    double overhead = std::numeric_limits< double >::max();
+    for( size_t i = 0; i < repetitions; ++i )
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        opt.optimize( initial );
+        const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+        wall = std::min( wall, std::chrono::duration< double, std::milli >( stop - start ).count() );
+        overhead = std::min( overhead, opt.getStatistics().getOverheadSeconds() );
+    }
+
+    const size_t iterations = opt.getResultIterations();
+    std::cout << std::left << std::setw( 24 ) << name << std::right;
+    std::cout << std::setw( 10 ) << opt.getResultEvaluations();
+    std::cout << std::setw( 10 ) << iterations << ( iterations >= opt.getMaximumIterations() ? "*" : " " );
+    std::cout << std::setw( 14 ) << std::scientific << std::setprecision( 3 ) << opt.getResultError();
+    std::cout << std::setw( 12 ) << std::fixed << std::setprecision( 3 ) << wall;
+    std::cout << std::setw( 14 ) << std::setprecision( 1 ) << overhead * 1e9 / std::max< size_t >( iterations, 1 );
+    std::cout << std::endl;
+}
+
+template< typename BASE >
+void runAll( const std::string& method, const std::string& filter )
+{
+    const size_t dims[] = { 2, 4, 8, 20, 52, 100 };
+    run< Beale, BASE >( "Beale", method, 2, filter );
+    for( size_t i = 0; i < sizeof( dims ) / sizeof( dims[0] ); ++i )
+    {
+        run< Sphere, BASE >( "Sphere", method, dims[i], filter );
+    }
+    for( size_t i = 0; i < sizeof( dims ) / sizeof( dims[0] ); ++i )
+    {
+        run< Rosenbrock, BASE >( "Rosenbrock", method, dims[i], filter );
+    }
+    for( size_t i = 0; i < sizeof( dims ) / sizeof( dims[0] ); ++i )
+    {
+        if( dims[i] % 4 == 0 )
+        {
+            run< Quartic, BASE >( "Quartic", method, dims[i], filter );
+        }
+    }
+}
+
+int main( int argc, char* argv[] )
+{
+    const std::string filter = argc > 1 ? argv[1] : "";
+
+    std::cout << "DOWNHILL-SIMPLEX-METHOD BENCHMARK" << std::endl;
+    if( !cppmath::SimplexStatistics::ENABLED )
+    {
+        std::cout << "Statistics are compiled out, overhead is not available!" << std::endl;
+    }
+    std::cout << std::left << std::setw( 24 ) << "Function/Method/DIM" << std::right;
+    std::cout << std::setw( 10 ) << "Evals" << std::setw( 11 ) << "Iter" << std::setw( 14 ) << "f(x)";
+    std::cout << std::setw( 12 ) << "Wall [ms]" << std::setw( 14 ) << "Ovh [ns/it]" << std::endl;
+
+    runAll< LagariasT >( "Lagarias", filter );
+    runAll< NelderMeadT >( "NM", filter );
+
+    std::cout << "* maximum iterations reached" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include <Eigen/Dense>
+
+#include <cppmath/optimization/DownhillSimplexMethod.hpp>
+#include <cppmath/optimization/DownhillSimplexMethodNM.hpp>
+
+/**
+ * Measures the per-iteration overhead of the simplex methods, i.e. the time which is not spent in the objective.
+ * A sphere function is used as a nearly free objective and the optimization runs a fixed number of iterations.
+ */
+
+template< int DIM >
+class SphereLagarias: public cppmath::DownhillSimplexMethod< DIM >
+{
+public:
+    explicit SphereLagarias( size_t dimension ) :
+                    cppmath::DownhillSimplexMethod< DIM >( dimension )
+    {
+    }
+
+    virtual double func( const typename cppmath::DownhillSimplexMethod< DIM >::ParamsT& x ) const
+    {
+        return x.squaredNorm();
+    }
+};
+
+template< int DIM >
+class SphereNelderMead: public cppmath::DownhillSimplexMethodNM< DIM >
+{
+public:
+    explicit SphereNelderMead( size_t dimension ) :
+                    cppmath::DownhillSimplexMethodNM< DIM >( dimension )
+    {
+    }
+
+    virtual double func( const typename cppmath::DownhillSimplexMethodNM< DIM >::ParamsT& x ) const
+    {
+        return x.squaredNorm();
+    }
+};
+
+template< typename OPT >
+double measure( size_t dimension, size_t iterations )
+{
+    OPT opt( dimension );
+    opt.setMaximumIterations( iterations );
+    opt.setEpsilon( -1.0 ); // never converge by the function value
+    const typename OPT::ParamsT initial = OPT::ParamsT::LinSpaced( dimension, 1.0, 10.0 );
+
+    const size_t repetitions = 10;
+    size_t total = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( size_t i = 0; i < repetitions; ++i )
+    {
+        opt.optimize( initial );
+        total += opt.getResultIterations();
+    }
+    const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    return std::chrono::duration< double, std::nano >( stop - start ).count() / total;
+}
+
+template< int DIM >
+void measureFixed( size_t iterations )
+{
+    std::cout << std::setw( 6 ) << DIM << std::setw( 10 ) << "fixed";
+    std::cout << std::setw( 14 ) << measure< SphereLagarias< DIM > >( DIM, iterations );
+    std::cout << std::setw( 14 ) << measure< SphereNelderMead< DIM > >( DIM, iterations ) << std::endl;
+}
+
+void measureDynamic( size_t dim, size_t iterations )
+{
+    std::cout << std::setw( 6 ) << dim << std::setw( 10 ) << "dynamic";
+    std::cout << std::setw( 14 ) << measure< SphereLagarias< Eigen::Dynamic > >( dim, iterations );
+    std::cout << std::setw( 14 ) << measure< SphereNelderMead< Eigen::Dynamic > >( dim, iterations ) << std::endl;
+}
+
+int main()
+{
+    const size_t iterations = 2000;
+
+    std::cout << "DOWNHILL-SIMPLEX-METHOD: overhead per iteration in ns" << std::endl;
+    std::cout << std::setw( 6 ) << "DIM" << std::setw( 10 ) << "storage" << std::setw( 14 ) << "Lagarias"
+                    << std::setw( 14 ) << "Nelder-Mead" << std::endl;
+    std::cout << std::fixed << std::setprecision( 1 );
+
+    measureFixed< 2 >( iterations );
+    measureFixed< 5 >( iterations );
+    measureFixed< 10 >( iterations );
+    measureFixed< 20 >( iterations );
+    measureFixed< 50 >( iterations );
+
+    const size_t dims[] = { 2, 5, 10, 20, 50, 100 };
+    for( size_t i = 0; i < sizeof( dims ) / sizeof( dims[0] ); ++i )
+    {
+        measureDynamic( dims[i], iterations );
+    }
+
+    return EXIT_SUCCESS;
+}
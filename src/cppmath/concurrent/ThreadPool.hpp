@@ -0,0 +1,179 @@
+#ifndef CPPMATH_CONCURRENT_THREADPOOL_HPP_
+#define CPPMATH_CONCURRENT_THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cppmath
+{
+    /**
+     * A simple pool of persistent worker threads to execute independent tasks.
+     * Tasks are distributed dynamically, i.e. each thread fetches the next task index when it has finished its previous
+     * task. So a few long running tasks do not stall the other threads.
+     *
+     * \author cpieloth
+     * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * \param threads Number of threads including the calling thread, 0 uses the hardware concurrency.
+         */
+        explicit ThreadPool( size_t threads = 0 );
+
+        virtual ~ThreadPool();
+
+        /**
+         * Returns the number of threads which execute tasks, including the calling thread.
+         *
+         * \return Number of threads.
+         */
+        size_t getThreadCount() const;
+
+        /**
+         * Executes task(i) for i = 0..n-1 and blocks until all tasks are done. The calling thread participates.
+         * If the pool is already busy, e.g. on nested calls from a task, the tasks are executed by the calling thread.
+         * \attention task must be thread-safe and must not throw.
+         *
+         * \param n Number of tasks.
+         * \param task Function to call with the task index.
+         */
+        void parallelFor( size_t n, const std::function< void( size_t ) >& task );
+
+    private:
+        ThreadPool( const ThreadPool& );
+        ThreadPool& operator=( const ThreadPool& );
+
+        void work();
+        void runTasks();
+
+        std::vector< std::thread > m_workers;
+
+        std::mutex m_callMutex; /**< Serializes the calls of parallelFor(). */
+        std::mutex m_mutex; /**< Guards the job state. */
+        std::condition_variable m_cvStart;
+        std::condition_variable m_cvDone;
+
+        const std::function< void( size_t ) >* m_task;
+        size_t m_count;
+        std::atomic< size_t > m_next;
+        size_t m_active;
+        size_t m_generation;
+        bool m_stop;
+    };
+
+    inline ThreadPool::ThreadPool( size_t threads ) :
+                    m_task( NULL ), m_count( 0 ), m_next( 0 ), m_active( 0 ), m_generation( 0 ), m_stop( false )
+    {
+        if( threads == 0 )
+        {
+            threads = std::thread::hardware_concurrency();
+        }
+        for( size_t i = 1; i < threads; ++i )
+        {
+            m_workers.push_back( std::thread( &ThreadPool::work, this ) );
+        }
+    }
+
+    inline ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_stop = true;
+        }
+        m_cvStart.notify_all();
+        for( size_t i = 0; i < m_workers.size(); ++i )
+        {
+            m_workers[i].join();
+        }
+    }
+
+    inline size_t ThreadPool::getThreadCount() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    inline void ThreadPool::parallelFor( size_t n, const std::function< void( size_t ) >& task )
+    {
+        if( n == 0 )
+        {
+            return;
+        }
+        if( n == 1 || m_workers.empty() || !m_callMutex.try_lock() )
+        {
+            for( size_t i = 0; i < n; ++i )
+            {
+                task( i );
+            }
+            return;
+        }
+
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_task = &task;
+            m_count = n;
+            m_next = 0;
+            m_active = m_workers.size();
+            ++m_generation;
+        }
+        m_cvStart.notify_all();
+
+        runTasks();
+
+        {
+            std::unique_lock< std::mutex > lock( m_mutex );
+            while( m_active > 0 )
+            {
+                m_cvDone.wait( lock );
+            }
+            m_task = NULL;
+        }
+        m_callMutex.unlock();
+    }
+
+    inline void ThreadPool::work()
+    {
+        size_t generation = 0;
+        std::unique_lock< std::mutex > lock( m_mutex );
+        while( true )
+        {
+            while( !m_stop && m_generation == generation )
+            {
+                m_cvStart.wait( lock );
+            }
+            if( m_stop )
+            {
+                return;
+            }
+            generation = m_generation;
+
+            lock.unlock();
+            runTasks();
+            lock.lock();
+
+            if( --m_active == 0 )
+            {
+                m_cvDone.notify_one();
+            }
+        }
+    }
+
+    inline void ThreadPool::runTasks()
+    {
+        const std::function< void( size_t ) >& task = *m_task;
+        for( size_t i = m_next++; i < m_count; i = m_next++ )
+        {
+            task( i );
+        }
+    }
+} /* namespace cppmath */
+
+#endif  // CPPMATH_CONCURRENT_THREADPOOL_HPP_
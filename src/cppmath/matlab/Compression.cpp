@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cstring> // memset
+#include <limits>
+#include <string>
+
+#include "../Logger.hpp"
+#include "Compression.hpp"
+
+using namespace cppmath;
+
+namespace
+{
+    /**
+     * zlib counts the available bytes with uInt, so larger buffers are passed in chunks.
+     */
+    const size_t MAX_CHUNK = std::numeric_limits< uInt >::max();
+}
+
+const std::string matlab::Inflater::CLASS = "Inflater";
+const size_t matlab::Inflater::BUFFER_SIZE;
+
+matlab::Inflater::Inflater( std::istream& is, size_t numBytes ) :
+                m_is( &is ), m_pos( is.tellg() ), m_source( NULL ), m_data( NULL ), m_remaining( numBytes ),
+                m_buffer( std::min( numBytes, BUFFER_SIZE ) ), m_valid( false )
+{
+    memset( &m_stream, 0, sizeof( m_stream ) );
+    m_valid = inflateInit( &m_stream ) == Z_OK;
+    if( !m_valid )
+    {
+        log::error( CLASS ) << "Could not initialize zlib!";
+    }
+}
+
+matlab::Inflater::Inflater( DataSource* const source, size_t numBytes ) :
+                m_is( NULL ), m_pos( 0 ), m_source( source ), m_data( NULL ), m_remaining( numBytes ),
+                m_buffer( std::min( numBytes, BUFFER_SIZE ) ), m_valid( false )
+{
+    memset( &m_stream, 0, sizeof( m_stream ) );
+    m_valid = inflateInit( &m_stream ) == Z_OK;
+    if( !m_valid )
+    {
+        log::error( CLASS ) << "Could not initialize zlib!";
+    }
+}
+
+matlab::Inflater::Inflater( const char* data, size_t numBytes ) :
+                m_is( NULL ), m_pos( 0 ), m_source( NULL ), m_data( data ), m_remaining( numBytes ), m_valid( false )
+{
+    memset( &m_stream, 0, sizeof( m_stream ) );
+    m_valid = inflateInit( &m_stream ) == Z_OK;
+    if( !m_valid )
+    {
+        log::error( CLASS ) << "Could not initialize zlib!";
+    }
+}
+
+matlab::Inflater::~Inflater()
+{
+    inflateEnd( &m_stream );
+}
+
+bool matlab::Inflater::isValid() const
+{
+    return m_valid;
+}
+
+bool matlab::Inflater::fill()
+{
+    if( ( m_is == NULL && m_source == NULL && m_data == NULL ) || m_remaining == 0 )
+    {
+        return false;
+    }
+    if( m_data != NULL )
+    {
+        const size_t bytes = std::min( m_remaining, MAX_CHUNK );
+        m_stream.next_in = reinterpret_cast< Bytef* >( const_cast< char* >( m_data ) );
+        m_stream.avail_in = bytes;
+        m_data += bytes;
+        m_remaining -= bytes;
+        return true;
+    }
+    const size_t bytes = std::min( m_remaining, m_buffer.size() );
+    if( m_source != NULL )
+    {
+        if( !m_source->read( m_buffer.data(), bytes ) )
+        {
+            log::error( CLASS ) << "Could not read compressed data!";
+            return false;
+        }
+    }
+    else
+    {
+        // Others may have moved the stream position in the meantime.
+        m_is->seekg( m_pos );
+        m_is->read( m_buffer.data(), bytes );
+        if( !m_is->good() )
+        {
+            log::error( CLASS ) << "Could not read compressed data!";
+            return false;
+        }
+        m_pos += bytes;
+    }
+    m_remaining -= bytes;
+    m_stream.next_in = reinterpret_cast< Bytef* >( m_buffer.data() );
+    m_stream.avail_in = bytes;
+    return true;
+}
+
+bool matlab::Inflater::read( void* const data, size_t numBytes )
+{
+    if( !m_valid )
+    {
+        return false;
+    }
+
+    Bytef* out = static_cast< Bytef* >( data );
+    while( numBytes > 0 )
+    {
+        const size_t bytes = std::min( numBytes, MAX_CHUNK );
+        m_stream.next_out = out;
+        m_stream.avail_out = bytes;
+        while( m_stream.avail_out > 0 )
+        {
+            if( m_stream.avail_in == 0 && !fill() )
+            {
+                log::error( CLASS ) << "Unexpected end of compressed data!";
+                m_valid = false;
+                return false;
+            }
+            const int rc = inflate( &m_stream, Z_NO_FLUSH );
+            if( rc == Z_STREAM_END && m_stream.avail_out > 0 )
+            {
+                log::error( CLASS ) << "Unexpected end of compressed data!";
+                m_valid = false;
+                return false;
+            }
+            if( rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR )
+            {
+                log::error( CLASS ) << "Could not inflate data: " << rc;
+                m_valid = false;
+                return false;
+            }
+        }
+        out += bytes;
+        numBytes -= bytes;
+    }
+    return true;
+}
+
+bool matlab::Inflater::skip( size_t numBytes )
+{
+    char tmp[256];
+    while( numBytes > 0 )
+    {
+        const size_t bytes = std::min( numBytes, sizeof( tmp ) );
+        if( !read( tmp, bytes ) )
+        {
+            return false;
+        }
+        numBytes -= bytes;
+    }
+    return true;
+}
+
+size_t matlab::Inflater::getTotalOut() const
+{
+    return m_stream.total_out;
+}
+
+const std::string matlab::Deflater::CLASS = "Deflater";
+const size_t matlab::Deflater::BUFFER_SIZE;
+
+matlab::Deflater::Deflater( std::ostream& os, int level ) :
+                m_os( os ), m_buffer( BUFFER_SIZE ), m_valid( false )
+{
+    memset( &m_stream, 0, sizeof( m_stream ) );
+    m_valid = deflateInit( &m_stream, level ) == Z_OK;
+    if( !m_valid )
+    {
+        log::error( CLASS ) << "Could not initialize zlib, compression level: " << level;
+    }
+}
+
+matlab::Deflater::~Deflater()
+{
+    deflateEnd( &m_stream );
+}
+
+bool matlab::Deflater::isValid() const
+{
+    return m_valid;
+}
+
+bool matlab::Deflater::deflate( int flush )
+{
+    int rc;
+    do
+    {
+        m_stream.next_out = reinterpret_cast< Bytef* >( m_buffer.data() );
+        m_stream.avail_out = m_buffer.size();
+        rc = ::deflate( &m_stream, flush );
+        if( rc == Z_STREAM_ERROR )
+        {
+            log::error( CLASS ) << "Could not deflate data!";
+            m_valid = false;
+            return false;
+        }
+        m_os.write( m_buffer.data(), m_buffer.size() - m_stream.avail_out );
+        if( !m_os.good() )
+        {
+            log::error( CLASS ) << "Could not write compressed data!";
+            m_valid = false;
+            return false;
+        }
+    } while( m_stream.avail_out == 0 || ( flush == Z_FINISH && rc != Z_STREAM_END ) );
+    return true;
+}
+
+bool matlab::Deflater::write( const void* const data, size_t numBytes )
+{
+    if( !m_valid )
+    {
+        return false;
+    }
+    Bytef* in = reinterpret_cast< Bytef* >( const_cast< void* >( data ) );
+    while( numBytes > 0 )
+    {
+        const size_t bytes = std::min( numBytes, MAX_CHUNK );
+        m_stream.next_in = in;
+        m_stream.avail_in = bytes;
+        if( !deflate( Z_NO_FLUSH ) )
+        {
+            return false;
+        }
+        in += bytes;
+        numBytes -= bytes;
+    }
+    return true;
+}
+
+bool matlab::Deflater::finish()
+{
+    if( !m_valid )
+    {
+        return false;
+    }
+    return deflate( Z_FINISH );
+}
+
+size_t matlab::Deflater::getTotalOut() const
+{
+    return m_stream.total_out;
+}
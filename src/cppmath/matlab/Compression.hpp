@@ -0,0 +1,172 @@
+#ifndef CPPMATH_MATLAB_COMPRESSION_H_
+#define CPPMATH_MATLAB_COMPRESSION_H_
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "DataSource.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Streaming decompression of a miCOMPRESSED data element.
+         * Data is inflated directly into the destination buffer, only the compressed input is buffered.
+         *
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class Inflater: public DataSource
+        {
+        public:
+            static const std::string CLASS;
+
+            /**
+             * Size of the buffer for compressed input read from a stream.
+             */
+            static const size_t BUFFER_SIZE = 64 * 1024;
+
+            /**
+             * Inflates compressed data from a stream, starting at the current position.
+             * The stream can be used by others between the reads.
+             *
+             * \param is Open input stream to read from.
+             * \param numBytes Number of compressed bytes.
+             */
+            Inflater( std::istream& is, size_t numBytes );
+
+            /**
+             * Inflates compressed data from another source, e.g. positional reads on a file.
+             *
+             * \param source Source positioned at the compressed data, must exist as long as the inflater.
+             * \param numBytes Number of compressed bytes.
+             */
+            Inflater( DataSource* const source, size_t numBytes );
+
+            /**
+             * Inflates compressed data from memory, e.g. a mapped file.
+             *
+             * \param data Compressed data.
+             * \param numBytes Number of compressed bytes.
+             */
+            Inflater( const char* data, size_t numBytes );
+
+            virtual ~Inflater();
+
+            bool isValid() const;
+
+            /**
+             * Inflates the next bytes into data.
+             *
+             * \param data Destination with space for numBytes.
+             * \param numBytes Number of uncompressed bytes to read.
+             * \return true, if numBytes were inflated.
+             */
+            virtual bool read( void* const data, size_t numBytes );
+
+            /**
+             * Inflates and discards the next bytes.
+             *
+             * \param numBytes Number of uncompressed bytes to skip.
+             * \return true, if numBytes were skipped.
+             */
+            virtual bool skip( size_t numBytes );
+
+            /**
+             * Gets the number of uncompressed bytes, which were read or skipped.
+             *
+             * \return Position in the uncompressed data.
+             */
+            size_t getTotalOut() const;
+
+        private:
+            Inflater( const Inflater& );
+
+            Inflater& operator=( const Inflater& );
+
+            bool fill();
+
+            z_stream m_stream;
+            std::istream* m_is;
+            std::streampos m_pos; /**< Stream position of the next compressed input. */
+            DataSource* m_source;
+            const char* m_data; /**< Next compressed input in memory. */
+            size_t m_remaining;
+            std::vector< char > m_buffer;
+            bool m_valid;
+        };
+
+        /**
+         * Streaming compression of a miCOMPRESSED data element.
+         * Only the compressed output is buffered.
+         *
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class Deflater
+        {
+        public:
+            static const std::string CLASS;
+
+            /**
+             * Size of the buffer for compressed output.
+             */
+            static const size_t BUFFER_SIZE = 64 * 1024;
+
+            /**
+             * Deflates data to a stream, starting at the current position.
+             *
+             * \param os Open output stream to write to.
+             * \param level Compression level, 0 (none) to 9 (best) or -1 for the zlib default.
+             */
+            Deflater( std::ostream& os, int level );
+
+            ~Deflater();
+
+            bool isValid() const;
+
+            /**
+             * Compresses data and writes the output, which is available.
+             *
+             * \param data Uncompressed data.
+             * \param numBytes Number of bytes.
+             * \return true, if successful.
+             */
+            bool write( const void* const data, size_t numBytes );
+
+            /**
+             * Flushes the remaining output. Must be called once after the last write().
+             *
+             * \return true, if successful.
+             */
+            bool finish();
+
+            /**
+             * Gets the number of compressed bytes, which were written to the stream.
+             *
+             * \return Written bytes.
+             */
+            size_t getTotalOut() const;
+
+        private:
+            Deflater( const Deflater& );
+
+            Deflater& operator=( const Deflater& );
+
+            bool deflate( int flush );
+
+            z_stream m_stream;
+            std::ostream& m_os;
+            std::vector< char > m_buffer;
+            bool m_valid;
+        };
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_COMPRESSION_H_
@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <cstring> // memcpy
+#include <string>
+#include <type_traits>
+
+#include <errno.h>
+#include <unistd.h> // pread
+
+#include <Eigen/Core>
+
+#include "../Logger.hpp"
+#include "DataSource.hpp"
+#include "io.hpp"
+
+using namespace cppmath;
+
+namespace
+{
+    const std::string CLASS = "DataSource";
+
+    /**
+     * Number of values, which are converted at once.
+     */
+    const size_t CHUNK_SIZE = 4096;
+
+    /**
+     * Reads the values of the stored type S and converts them to T. Value i is stored at data[i * STRIDE].
+     * If count is null, the element must contain exactly size values, otherwise up to size values.
+     */
+    template< size_t STRIDE, typename S, typename T >
+    bool readConverted( T* const data, size_t size, size_t* const count, matlab::mNumBytes_t numBytes,
+                    matlab::DataSource* const source, bool swapBytes )
+    {
+        const bool isMatch = count == NULL ? numBytes == size * sizeof(S) : numBytes <= size * sizeof(S);
+        if( !isMatch || numBytes % sizeof(S) )
+        {
+            log::error( CLASS ) << "Number of Bytes does not match the dimension: " << numBytes;
+            return false;
+        }
+        size = numBytes / sizeof(S);
+        if( count != NULL )
+        {
+            *count = size;
+        }
+
+        if( std::is_same< S, T >::value && STRIDE == 1 )
+        {
+            if( !source->read( data, numBytes ) )
+            {
+                return false;
+            }
+            if( swapBytes )
+            {
+                matlab::ByteOrder::swap( data, size, sizeof(S) );
+            }
+            return true;
+        }
+
+        S buffer[CHUNK_SIZE];
+        for( size_t i = 0; i < size; i += CHUNK_SIZE )
+        {
+            const size_t n = std::min( CHUNK_SIZE, size - i );
+            if( !source->read( buffer, n * sizeof(S) ) )
+            {
+                return false;
+            }
+            if( swapBytes )
+            {
+                matlab::ByteOrder::swap( buffer, n, sizeof(S) );
+            }
+            if( STRIDE == 1 )
+            {
+                Eigen::Map< Eigen::Array< T, Eigen::Dynamic, 1 > >( data + i, n ) = Eigen::Map<
+                                const Eigen::Array< S, Eigen::Dynamic, 1 > >( buffer, n ).template cast< T >();
+            }
+            else
+            {
+                // Constant stride, so the compiler vectorizes the interleaving.
+                T* const dst = data + i * STRIDE;
+                for( size_t j = 0; j < n; ++j )
+                {
+                    dst[j * STRIDE] = static_cast< T >( buffer[j] );
+                }
+            }
+        }
+        return true;
+    }
+
+    template< size_t STRIDE, typename T >
+    bool readConverted( T* const data, size_t size, size_t* const count, matlab::mDataType_t dataType,
+                    matlab::mNumBytes_t numBytes, matlab::DataSource* const source, bool swapBytes )
+    {
+        switch( dataType )
+        {
+            case matlab::DataTypes::miINT8:
+                return readConverted< STRIDE, matlab::miINT8_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT8:
+                return readConverted< STRIDE, matlab::miUINT8_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miINT16:
+                return readConverted< STRIDE, matlab::miINT16_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT16:
+                return readConverted< STRIDE, matlab::miUINT16_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miINT32:
+                return readConverted< STRIDE, matlab::miINT32_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT32:
+                return readConverted< STRIDE, matlab::miUINT32_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miSINGLE:
+                return readConverted< STRIDE, matlab::miSinge_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miDOUBLE:
+                return readConverted< STRIDE, matlab::miDouble_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miINT64:
+                return readConverted< STRIDE, matlab::miINT64_t >( data, size, count, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT64:
+                return readConverted< STRIDE, matlab::miUINT64_t >( data, size, count, numBytes, source, swapBytes );
+            default:
+                log::error( CLASS ) << "Data type is not numeric: " << dataType;
+                return false;
+        }
+    }
+
+    /**
+     * Reads a block of a column-major array of the stored type S and converts it to T.
+     * Skips to the first column and the rows between the columns of the block.
+     */
+    template< typename S, typename T >
+    bool readBlockConverted( T* const data, size_t rows, size_t cols, size_t startRow, size_t startCol,
+                    size_t blockRows, size_t blockCols, matlab::mNumBytes_t numBytes, matlab::DataSource* const source,
+                    bool swapBytes )
+    {
+        if( numBytes != rows * cols * sizeof(S) )
+        {
+            log::error( CLASS ) << "Number of Bytes does not match the dimension: " << numBytes;
+            return false;
+        }
+        if( !source->skip( ( startCol * rows + startRow ) * sizeof(S) ) )
+        {
+            return false;
+        }
+        if( blockRows == rows )
+        {
+            // Columns are contiguous.
+            const size_t size = blockRows * blockCols;
+            return readConverted< 1, S >( data, size, NULL, size * sizeof(S), source, swapBytes );
+        }
+
+        const size_t gap = ( rows - blockRows ) * sizeof(S);
+        for( size_t c = 0; c < blockCols; ++c )
+        {
+            if( ( c > 0 && !source->skip( gap ) )
+                            || !readConverted< 1, S >( data + c * blockRows, blockRows, NULL, blockRows * sizeof(S),
+                                            source, swapBytes ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template< typename T >
+    bool readBlockConverted( T* const data, size_t rows, size_t cols, size_t startRow, size_t startCol,
+                    size_t blockRows, size_t blockCols, matlab::mDataType_t dataType, matlab::mNumBytes_t numBytes,
+                    matlab::DataSource* const source, bool swapBytes )
+    {
+        switch( dataType )
+        {
+            case matlab::DataTypes::miINT8:
+                return readBlockConverted< matlab::miINT8_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT8:
+                return readBlockConverted< matlab::miUINT8_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miINT16:
+                return readBlockConverted< matlab::miINT16_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT16:
+                return readBlockConverted< matlab::miUINT16_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miINT32:
+                return readBlockConverted< matlab::miINT32_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT32:
+                return readBlockConverted< matlab::miUINT32_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miSINGLE:
+                return readBlockConverted< matlab::miSinge_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miDOUBLE:
+                return readBlockConverted< matlab::miDouble_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miINT64:
+                return readBlockConverted< matlab::miINT64_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            case matlab::DataTypes::miUINT64:
+                return readBlockConverted< matlab::miUINT64_t >( data, rows, cols, startRow, startCol, blockRows,
+                                blockCols, numBytes, source, swapBytes );
+            default:
+                log::error( CLASS ) << "Data type is not numeric: " << dataType;
+                return false;
+        }
+    }
+
+    /**
+     * Reads tag and data of a numeric data element. Value i is stored at data[i * STRIDE].
+     */
+    template< size_t STRIDE, typename T >
+    bool readElement( T* const data, size_t size, size_t* const count, matlab::DataSource* const source,
+                    bool swapBytes )
+    {
+        matlab::mDataType_t tag[2];
+        if( !source->read( tag, sizeof( tag ) ) )
+        {
+            log::error( CLASS ) << "Could not read Data Element!";
+            return false;
+        }
+        if( swapBytes )
+        {
+            matlab::ByteOrder::swap( &tag[0], 1, sizeof(matlab::mDataType_t) );
+        }
+
+        if( tag[0] > matlab::DataTypes::miUTF32 )
+        {
+            // Small Data Element Format, data is stored in the tag.
+            const matlab::mDataType_t dataType = tag[0] & 0xFFFF;
+            const matlab::mNumBytes_t numBytes = tag[0] >> 16;
+            matlab::MemorySource small( &tag[1], std::min< matlab::mNumBytes_t >( numBytes, 4 ) );
+            return readConverted< STRIDE >( data, size, count, dataType, numBytes, &small, swapBytes );
+        }
+
+        if( swapBytes )
+        {
+            matlab::ByteOrder::swap( &tag[1], 1, sizeof(matlab::mNumBytes_t) );
+        }
+        if( !readConverted< STRIDE >( data, size, count, tag[0], tag[1], source, swapBytes ) )
+        {
+            return false;
+        }
+        if( tag[1] % 8 )
+        {
+            return source->skip( 8 - ( tag[1] % 8 ) );
+        }
+        return true;
+    }
+}
+
+matlab::DataSource::~DataSource()
+{
+}
+
+matlab::StreamSource::StreamSource( std::istream& is ) :
+                m_is( is )
+{
+}
+
+matlab::StreamSource::~StreamSource()
+{
+}
+
+bool matlab::StreamSource::read( void* const data, size_t numBytes )
+{
+    m_is.read( ( char* )data, numBytes );
+    return m_is.good();
+}
+
+bool matlab::StreamSource::skip( size_t numBytes )
+{
+    m_is.seekg( numBytes, std::istream::cur );
+    return m_is.good();
+}
+
+matlab::MemorySource::MemorySource( const void* const data, size_t numBytes ) :
+                m_data( static_cast< const char* >( data ) ), m_remaining( numBytes )
+{
+}
+
+matlab::MemorySource::~MemorySource()
+{
+}
+
+bool matlab::MemorySource::read( void* const data, size_t numBytes )
+{
+    if( numBytes > m_remaining )
+    {
+        return false;
+    }
+    memcpy( data, m_data, numBytes );
+    m_data += numBytes;
+    m_remaining -= numBytes;
+    return true;
+}
+
+bool matlab::MemorySource::skip( size_t numBytes )
+{
+    if( numBytes > m_remaining )
+    {
+        return false;
+    }
+    m_data += numBytes;
+    m_remaining -= numBytes;
+    return true;
+}
+
+matlab::PositionalSource::PositionalSource( int fd, size_t offset ) :
+                m_fd( fd ), m_offset( offset )
+{
+}
+
+matlab::PositionalSource::~PositionalSource()
+{
+}
+
+bool matlab::PositionalSource::read( void* const data, size_t numBytes )
+{
+    char* dst = static_cast< char* >( data );
+    while( numBytes > 0 )
+    {
+        const ssize_t bytes = ::pread( m_fd, dst, numBytes, m_offset );
+        if( bytes < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if( bytes <= 0 )
+        {
+            return false;
+        }
+        dst += bytes;
+        numBytes -= bytes;
+        m_offset += bytes;
+    }
+    return true;
+}
+
+bool matlab::PositionalSource::skip( size_t numBytes )
+{
+    m_offset += numBytes;
+    return true;
+}
+
+template< typename T >
+bool matlab::readNumericData( T* const data, size_t size, DataSource* const source, bool swapBytes,
+                size_t* const count )
+{
+    return readElement< 1 >( data, size, count, source, swapBytes );
+}
+
+template< typename T >
+bool matlab::readNumericDataInterleaved( T* const data, size_t size, DataSource* const source, bool swapBytes )
+{
+    return readElement< 2 >( data, size, NULL, source, swapBytes );
+}
+
+template< typename T >
+bool matlab::readNumericBlock( T* const data, size_t rows, size_t cols, size_t startRow, size_t startCol,
+                size_t blockRows, size_t blockCols, DataSource* const source, bool swapBytes )
+{
+    if( startRow + blockRows > rows || startCol + blockCols > cols )
+    {
+        log::error( CLASS ) << "Block is out of range: " << blockRows << "x" << blockCols << " at (" << startRow
+                        << ", " << startCol << ") of " << rows << "x" << cols;
+        return false;
+    }
+
+    mDataType_t tag[2];
+    if( !source->read( tag, sizeof( tag ) ) )
+    {
+        log::error( CLASS ) << "Could not read Data Element!";
+        return false;
+    }
+    if( swapBytes )
+    {
+        ByteOrder::swap( tag, 2, sizeof(mDataType_t) );
+    }
+
+    if( tag[0] > DataTypes::miUTF32 )
+    {
+        // Small Data Element Format, data is stored in the tag.
+        const mDataType_t dataType = tag[0] & 0xFFFF;
+        const mNumBytes_t numBytes = tag[0] >> 16;
+        if( swapBytes )
+        {
+            ByteOrder::swap( &tag[1], 1, sizeof(mNumBytes_t) );
+        }
+        MemorySource small( &tag[1], std::min< mNumBytes_t >( numBytes, 4 ) );
+        return readBlockConverted( data, rows, cols, startRow, startCol, blockRows, blockCols, dataType, numBytes,
+                        &small, swapBytes );
+    }
+    return readBlockConverted( data, rows, cols, startRow, startCol, blockRows, blockCols, tag[0], tag[1], source,
+                    swapBytes );
+}
+
+template bool matlab::readNumericData< double >( double* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< float >( float* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< int8_t >( int8_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< uint8_t >( uint8_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< int16_t >( int16_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< uint16_t >( uint16_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< int32_t >( int32_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< uint32_t >( uint32_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< int64_t >( int64_t* const, size_t, DataSource* const, bool, size_t* const );
+template bool matlab::readNumericData< uint64_t >( uint64_t* const, size_t, DataSource* const, bool, size_t* const );
+
+template bool matlab::readNumericDataInterleaved< double >( double* const, size_t, DataSource* const, bool );
+template bool matlab::readNumericDataInterleaved< float >( float* const, size_t, DataSource* const, bool );
+
+template bool matlab::readNumericBlock< double >( double* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< float >( float* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< int8_t >( int8_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< uint8_t >( uint8_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< int16_t >( int16_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< uint16_t >( uint16_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< int32_t >( int32_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< uint32_t >( uint32_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< int64_t >( int64_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
+template bool matlab::readNumericBlock< uint64_t >( uint64_t* const, size_t, size_t, size_t, size_t, size_t, size_t,
+                DataSource* const, bool );
@@ -0,0 +1,154 @@
+#ifndef CPPMATH_MATLAB_DATASOURCE_H_
+#define CPPMATH_MATLAB_DATASOURCE_H_
+
+#include <cstddef>
+#include <istream>
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Sequential source of the bytes of a data element, e.g. a stream or inflated data.
+         *
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class DataSource
+        {
+        public:
+            virtual ~DataSource();
+
+            /**
+             * Reads the next bytes into data.
+             *
+             * \param data Destination with space for numBytes.
+             * \param numBytes Number of bytes to read.
+             * \return true, if numBytes were read.
+             */
+            virtual bool read( void* const data, size_t numBytes ) = 0;
+
+            /**
+             * Skips the next bytes.
+             *
+             * \param numBytes Number of bytes to skip.
+             * \return true, if numBytes were skipped.
+             */
+            virtual bool skip( size_t numBytes ) = 0;
+        };
+
+        /**
+         * Reads from the current position of a stream.
+         */
+        class StreamSource: public DataSource
+        {
+        public:
+            explicit StreamSource( std::istream& is );
+
+            virtual ~StreamSource();
+
+            virtual bool read( void* const data, size_t numBytes );
+
+            virtual bool skip( size_t numBytes );
+
+        private:
+            std::istream& m_is;
+        };
+
+        /**
+         * Reads from memory, e.g. a mapped file.
+         */
+        class MemorySource: public DataSource
+        {
+        public:
+            MemorySource( const void* const data, size_t numBytes );
+
+            virtual ~MemorySource();
+
+            virtual bool read( void* const data, size_t numBytes );
+
+            virtual bool skip( size_t numBytes );
+
+        private:
+            const char* m_data;
+            size_t m_remaining;
+        };
+
+        /**
+         * Reads with positional reads (pread) from a file descriptor, starting at an offset.
+         * The position is kept by the source and not by the file descriptor,
+         * so several sources can read from the same file descriptor concurrently.
+         */
+        class PositionalSource: public DataSource
+        {
+        public:
+            PositionalSource( int fd, size_t offset );
+
+            virtual ~PositionalSource();
+
+            virtual bool read( void* const data, size_t numBytes );
+
+            virtual bool skip( size_t numBytes );
+
+        private:
+            const int m_fd;
+            size_t m_offset;
+        };
+
+        /**
+         * Reads a numeric data element, i.e. tag and data, and converts the data to the scalar type T.
+         * All numeric storage types are supported, e.g. a double matrix which is stored as miINT16.
+         * The conversion is done in chunks by Eigen, which vectorizes the casts if possible.
+         * Available for T: double, float, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t.
+         *
+         * \param data Destination with space for size values.
+         * \param size Number of values, must match the data element if count is null.
+         * \param source Source positioned at the tag of the data element.
+         * \param swapBytes True, if the byte order of the data differs from the host.
+         * \param count If not null, the data element may contain up to size values and the number of read values
+         *        is stored.
+         * \return true, if successful, false otherwise.
+         */
+        template< typename T >
+        bool readNumericData( T* const data, size_t size, DataSource* const source, bool swapBytes = false,
+                        size_t* const count = NULL );
+
+        /**
+         * Reads a numeric data element like readNumericData(), but stores value i at data[2 * i].
+         * This reads the real or imaginary part directly into interleaved complex values without a temporary.
+         * Available for T: double, float.
+         *
+         * \param data Destination with space for 2 * size values, e.g. the real part of the first complex value.
+         * \param size Number of values, must match the data element.
+         * \param source Source positioned at the tag of the data element.
+         * \param swapBytes True, if the byte order of the data differs from the host.
+         * \return true, if successful, false otherwise.
+         */
+        template< typename T >
+        bool readNumericDataInterleaved( T* const data, size_t size, DataSource* const source,
+                        bool swapBytes = false );
+
+        /**
+         * Reads a block of a column-major numeric data element and converts it to T, see readNumericData().
+         * The source skips to the first column of the block and the rows between the columns,
+         * so only the block is read from sources which can seek, e.g. a stream or positional reads.
+         * The position of the source is behind the block afterwards.
+         *
+         * \param data Destination with space for blockRows * blockCols values in column-major order.
+         * \param rows Number of rows of the whole array.
+         * \param cols Number of columns of the whole array.
+         * \param startRow First row of the block.
+         * \param startCol First column of the block.
+         * \param blockRows Number of rows of the block.
+         * \param blockCols Number of columns of the block.
+         * \param source Source positioned at the tag of the data element.
+         * \param swapBytes True, if the byte order of the data differs from the host.
+         * \return true, if successful, false otherwise.
+         */
+        template< typename T >
+        bool readNumericBlock( T* const data, size_t rows, size_t cols, size_t startRow, size_t startCol,
+                        size_t blockRows, size_t blockCols, DataSource* const source, bool swapBytes = false );
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_DATASOURCE_H_
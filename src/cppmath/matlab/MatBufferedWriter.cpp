@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring> // memcpy, memset, strerror
+#include <limits>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "../Logger.hpp"
+#include "MatBufferedWriter.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatBufferedWriter::CLASS = "MatBufferedWriter";
+const size_t matlab::MatBufferedWriter::DEFAULT_BUFFER_SIZE;
+
+matlab::MatBufferedWriter::MatBufferedWriter( size_t bufferSize ) :
+                m_fd( -1 ), m_buffer( bufferSize ), m_size( 0 ), m_writtenBytes( 0 ), m_error( 0 )
+{
+}
+
+matlab::MatBufferedWriter::~MatBufferedWriter()
+{
+    if( isOpen() )
+    {
+        close();
+    }
+}
+
+bool matlab::MatBufferedWriter::open( const std::string& fileName, const std::string& description )
+{
+    if( isOpen() && !close() )
+    {
+        log::warn( CLASS ) << "Could not close previous file!";
+    }
+
+    m_size = 0;
+    m_writtenBytes = 0;
+    m_error = 0;
+    m_fd = ::open( fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( m_fd < 0 )
+    {
+        m_error = errno;
+        log::error( CLASS ) << "Could not open file: " << fileName << " (" << strerror( m_error ) << ")";
+        return false;
+    }
+
+    // Add header //
+    // ---------- //
+    reserve( 128 );
+    char* const header = m_buffer.data() + m_size;
+    memset( header, 0, 128 );
+    memcpy( header, description.c_str(), std::min< size_t >( 115, description.length() ) );
+    header[116] = 0x20; // subsys data offset
+    header[124] = 0x00; // version
+    header[125] = 0x01;
+    header[126] = 'I'; // endian indicator
+    header[127] = 'M';
+    m_size += 128;
+
+    return true;
+}
+
+bool matlab::MatBufferedWriter::close()
+{
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "File is not open!";
+        return false;
+    }
+
+    const bool success = flush();
+    if( ::close( m_fd ) != 0 && m_error == 0 )
+    {
+        m_error = errno;
+        log::error( CLASS ) << "Could not close file: " << strerror( m_error );
+    }
+    m_fd = -1;
+    m_size = 0;
+    return success && m_error == 0;
+}
+
+bool matlab::MatBufferedWriter::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+bool matlab::MatBufferedWriter::writeMatrixDouble( const Eigen::MatrixXd& matrix, const std::string& arrayName )
+{
+    if( !isOpen() || m_error != 0 )
+    {
+        log::error( CLASS ) << "File is not open or a previous write failed!";
+        return false;
+    }
+
+    // Array Tag, Array Flags, Dimension, Array Name and Data Tag
+    size_t nameBytes = arrayName.length();
+    if( nameBytes % 8 )
+    {
+        nameBytes += 8 - ( nameBytes % 8 );
+    }
+    const size_t headerBytes = 8 + 16 + 16 + 8 + nameBytes + 8;
+    const size_t dataBytes = matrix.size() * sizeof(miDouble_t);
+    if( headerBytes - 8 + dataBytes > std::numeric_limits< mNumBytes_t >::max() )
+    {
+        log::error( CLASS ) << "Matrix exceeds the maximum element size!";
+        return false;
+    }
+
+    // Assemble header //
+    // --------------- //
+    if( !reserve( headerBytes ) )
+    {
+        return false;
+    }
+    addTagField( DataTypes::miMATRIX, headerBytes - 8 + dataBytes );
+
+    const mArrayFlags_t arrayFlags[2] = { ArrayTypes::mxDOUBLE_CLASS, 0 };
+    addTagField( DataTypes::miUINT32, sizeof( arrayFlags ) );
+    addBytes( arrayFlags, sizeof( arrayFlags ) );
+
+    const miINT32_t dims[2] = { static_cast< miINT32_t >( matrix.rows() ), static_cast< miINT32_t >( matrix.cols() ) };
+    addTagField( DataTypes::miINT32, sizeof( dims ) );
+    addBytes( dims, sizeof( dims ) );
+
+    addTagField( DataTypes::miINT8, arrayName.length() );
+    addBytes( arrayName.c_str(), arrayName.length() );
+    addPadding( arrayName.length() );
+
+    addTagField( DataTypes::miDOUBLE, dataBytes );
+
+    // Add data, no padding needed for double //
+    // -------------------------------------- //
+    if( m_size + dataBytes <= m_buffer.size() )
+    {
+        addBytes( matrix.data(), dataBytes );
+        return true;
+    }
+    return write( matrix.data(), dataBytes );
+}
+
+bool matlab::MatBufferedWriter::flush()
+{
+    if( !isOpen() || m_error != 0 )
+    {
+        return false;
+    }
+    return write( NULL, 0 );
+}
+
+size_t matlab::MatBufferedWriter::getWrittenBytes() const
+{
+    return m_writtenBytes;
+}
+
+size_t matlab::MatBufferedWriter::getBufferedBytes() const
+{
+    return m_size;
+}
+
+int matlab::MatBufferedWriter::getError() const
+{
+    return m_error;
+}
+
+bool matlab::MatBufferedWriter::reserve( size_t numBytes )
+{
+    if( m_size + numBytes <= m_buffer.size() )
+    {
+        return true;
+    }
+    if( !flush() )
+    {
+        return false;
+    }
+    if( numBytes > m_buffer.size() )
+    {
+        m_buffer.resize( numBytes );
+    }
+    return true;
+}
+
+void matlab::MatBufferedWriter::addTagField( const mDataType_t& dataType, const mNumBytes_t numBytes )
+{
+    addBytes( &dataType, sizeof( dataType ) );
+    addBytes( &numBytes, sizeof( numBytes ) );
+}
+
+void matlab::MatBufferedWriter::addBytes( const void* const data, size_t numBytes )
+{
+    memcpy( m_buffer.data() + m_size, data, numBytes );
+    m_size += numBytes;
+}
+
+void matlab::MatBufferedWriter::addPadding( size_t numBytes )
+{
+    if( numBytes % 8 )
+    {
+        numBytes = 8 - ( numBytes % 8 );
+        memset( m_buffer.data() + m_size, 0, numBytes );
+        m_size += numBytes;
+    }
+}
+
+bool matlab::MatBufferedWriter::write( const void* const data, size_t numBytes )
+{
+    struct iovec iov[2];
+    iov[0].iov_base = m_buffer.data();
+    iov[0].iov_len = m_size;
+    iov[1].iov_base = const_cast< void* >( data );
+    iov[1].iov_len = numBytes;
+
+    const bool success = writeAll( iov, numBytes > 0 ? 2 : 1 );
+    m_size = 0;
+    return success;
+}
+
+bool matlab::MatBufferedWriter::writeAll( struct iovec* iov, int count )
+{
+    while( count > 0 )
+    {
+        if( iov->iov_len == 0 )
+        {
+            ++iov;
+            --count;
+            continue;
+        }
+
+        const ssize_t written = writev( m_fd, iov, count );
+        if( written < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            m_error = errno;
+            log::error( CLASS ) << "Could not write: " << strerror( m_error );
+            return false;
+        }
+        m_writtenBytes += written;
+
+        // Skip written parts on partial writes
+        size_t remaining = written;
+        while( count > 0 && remaining >= iov->iov_len )
+        {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if( count > 0 )
+        {
+            iov->iov_base = static_cast< char* >( iov->iov_base ) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
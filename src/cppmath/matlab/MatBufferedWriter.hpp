@@ -0,0 +1,134 @@
+#ifndef CPPMATH_MATLAB_MATBUFFEREDWRITER_H_
+#define CPPMATH_MATLAB_MATBUFFEREDWRITER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "io.hpp"
+
+struct iovec;
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Writer for MAT-file format, which assembles whole elements in a user-space buffer.
+         * Small elements are collected in the buffer and written together. The data of large matrices is not copied,
+         * but written with the buffer in a single vectored write. Each write is checked, the first error is kept
+         * and fails all following operations.
+         *
+         * \attention Does only supports: little endian, 2-dim double matrices, no compression.
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatBufferedWriter
+        {
+        public:
+            static const std::string CLASS;
+
+            static const size_t DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+            /**
+             * Constructor.
+             *
+             * \param bufferSize Size of the buffer in bytes.
+             */
+            explicit MatBufferedWriter( size_t bufferSize = DEFAULT_BUFFER_SIZE );
+
+            /**
+             * Closes the file, if it is still open.
+             */
+            ~MatBufferedWriter();
+
+            /**
+             * Creates or truncates the file and adds the header.
+             *
+             * \param fileName Path to the MAT-file.
+             * \param description Description text for header.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( const std::string& fileName, const std::string& description );
+
+            /**
+             * Writes the buffer and closes the file.
+             *
+             * \return true, if all data was written, false otherwise.
+             */
+            bool close();
+
+            bool isOpen() const;
+
+            /**
+             * Adds a 2-dim matrix to the file.
+             *
+             * \param matrix Matrix to write.
+             * \param arrayName Variable name.
+             * \return true, if successful, false otherwise.
+             */
+            bool writeMatrixDouble( const Eigen::MatrixXd& matrix, const std::string& arrayName );
+
+            /**
+             * Writes the buffer to the file.
+             *
+             * \return true, if successful, false otherwise.
+             */
+            bool flush();
+
+            /**
+             * Gets the number of bytes, which were actually written to the file.
+             *
+             * \return Written bytes.
+             */
+            size_t getWrittenBytes() const;
+
+            /**
+             * Gets the number of bytes in the buffer, which are not yet written.
+             *
+             * \return Buffered bytes.
+             */
+            size_t getBufferedBytes() const;
+
+            /**
+             * Gets the error of the first failed write.
+             *
+             * \return errno of the failed write, 0 if there was no error.
+             */
+            int getError() const;
+
+        private:
+            MatBufferedWriter( const MatBufferedWriter& );
+
+            MatBufferedWriter& operator=( const MatBufferedWriter& );
+
+            /**
+             * Makes space for numBytes in the buffer. Writes the buffer or grows it, if necessary.
+             */
+            bool reserve( size_t numBytes );
+
+            void addTagField( const mDataType_t& dataType, const mNumBytes_t numBytes );
+
+            void addBytes( const void* const data, size_t numBytes );
+
+            void addPadding( size_t numBytes );
+
+            /**
+             * Writes the buffer followed by the data with a single vectored write.
+             */
+            bool write( const void* const data, size_t numBytes );
+
+            bool writeAll( struct iovec* iov, int count );
+
+            int m_fd;
+            std::vector< char > m_buffer;
+            size_t m_size; /**< Used bytes of the buffer. */
+            size_t m_writtenBytes;
+            int m_error;
+        };
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATBUFFEREDWRITER_H_
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <string>
+
+#include "../Logger.hpp"
+#include "Compression.hpp"
+#include "MatColumnReader.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatColumnReader::CLASS = "MatColumnReader";
+
+matlab::MatColumnReader::MatColumnReader() :
+                m_ifs( NULL ), m_posData( 0 ), m_swapBytes( false ), m_rows( 0 ), m_cols( 0 ), m_column( 0 )
+{
+}
+
+matlab::MatColumnReader::~MatColumnReader()
+{
+}
+
+bool matlab::MatColumnReader::open( const ElementInfo& element, std::ifstream& ifs, const FileInfo& info )
+{
+    close();
+
+    // Check some errors //
+    // ----------------- //
+    const bool isCompressed = element.dataType == DataTypes::miCOMPRESSED;
+    if( !isCompressed && info.fileSize <= static_cast< size_t >( element.posData ) )
+    {
+        log::error( CLASS ) << "Data position is beyond file end!";
+        return false;
+    }
+
+    if( element.dataType != DataTypes::miMATRIX && !isCompressed )
+    {
+        log::error( CLASS ) << "Data type is not a matrix: " << element.dataType;
+        return false;
+    }
+
+    if( ArrayFlags::getArrayType( element.arrayFlags ) != ArrayTypes::mxDOUBLE_CLASS )
+    {
+        log::error( CLASS ) << "Numeric Types does not match!";
+        return false;
+    }
+
+    // Read data tag //
+    // ------------- //
+    mDataType_t tag[2];
+    bool success;
+    if( isCompressed )
+    {
+        ifs.seekg( element.pos + static_cast< std::streamoff >( 8 ) );
+        m_inflater.reset( new Inflater( ifs, element.numBytes ) );
+        success = m_inflater->skip( element.posData ) && m_inflater->read( tag, 8 );
+    }
+    else
+    {
+        ifs.seekg( element.posData );
+        ifs.read( ( char* )tag, 8 );
+        success = ifs.good();
+        m_posData = ifs.tellg();
+    }
+    const bool swapBytes = ByteOrder::isSwapped( info );
+    if( swapBytes )
+    {
+        ByteOrder::swap( tag, 2, sizeof(mDataType_t) );
+    }
+    const size_t bytes = static_cast< size_t >( element.rows ) * element.cols * sizeof(miDouble_t);
+    if( !success || tag[0] != DataTypes::miDOUBLE || tag[1] != bytes )
+    {
+        log::error( CLASS ) << "Could not read data tag or compressed data type is not supported!";
+        ifs.clear();
+        close();
+        return false;
+    }
+
+    m_ifs = &ifs;
+    m_swapBytes = swapBytes;
+    m_rows = element.rows;
+    m_cols = element.cols;
+    m_column = 0;
+    return true;
+}
+
+void matlab::MatColumnReader::close()
+{
+    m_ifs = NULL;
+    m_inflater.reset();
+    m_posData = 0;
+    m_swapBytes = false;
+    m_rows = 0;
+    m_cols = 0;
+    m_column = 0;
+}
+
+bool matlab::MatColumnReader::isOpen() const
+{
+    return m_ifs != NULL;
+}
+
+size_t matlab::MatColumnReader::getRows() const
+{
+    return m_rows;
+}
+
+size_t matlab::MatColumnReader::getCols() const
+{
+    return m_cols;
+}
+
+size_t matlab::MatColumnReader::getColumn() const
+{
+    return m_column;
+}
+
+size_t matlab::MatColumnReader::getRemainingColumns() const
+{
+    return m_cols - m_column;
+}
+
+bool matlab::MatColumnReader::read( double* const data, size_t columns )
+{
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "Reader is not open!";
+        return false;
+    }
+    if( columns > getRemainingColumns() )
+    {
+        log::error( CLASS ) << "Columns exceed the matrix: " << m_column + columns << " > " << m_cols;
+        return false;
+    }
+
+    const size_t bytes = m_rows * columns * sizeof(miDouble_t);
+    if( m_inflater )
+    {
+        if( !m_inflater->read( data, bytes ) )
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // Others may have moved the stream position in the meantime.
+        m_ifs->seekg( m_posData + static_cast< std::streamoff >( m_rows * m_column * sizeof(miDouble_t) ) );
+        m_ifs->read( ( char* )data, bytes );
+        if( !m_ifs->good() )
+        {
+            log::error( CLASS ) << "Could not read columns!";
+            m_ifs->clear();
+            return false;
+        }
+    }
+    if( m_swapBytes )
+    {
+        ByteOrder::swap( data, m_rows * columns, sizeof(miDouble_t) );
+    }
+    m_column += columns;
+    return true;
+}
+
+bool matlab::MatColumnReader::read( Eigen::MatrixXd* const block, size_t* const columns )
+{
+    if( block == NULL || columns == NULL )
+    {
+        log::error( CLASS ) << "Block or columns is null!";
+        return false;
+    }
+    if( static_cast< size_t >( block->rows() ) != m_rows )
+    {
+        log::error( CLASS ) << "Rows of block does not match: " << block->rows() << " != " << m_rows;
+        return false;
+    }
+
+    *columns = std::min< size_t >( block->cols(), getRemainingColumns() );
+    return read( block->data(), *columns );
+}
+
+bool matlab::MatColumnReader::skip( size_t columns )
+{
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "Reader is not open!";
+        return false;
+    }
+    if( columns > getRemainingColumns() )
+    {
+        log::error( CLASS ) << "Columns exceed the matrix: " << m_column + columns << " > " << m_cols;
+        return false;
+    }
+
+    if( m_inflater && !m_inflater->skip( m_rows * columns * sizeof(miDouble_t) ) )
+    {
+        return false;
+    }
+    m_column += columns;
+    return true;
+}
@@ -0,0 +1,109 @@
+#ifndef CPPMATH_MATLAB_MATCOLUMNREADER_H_
+#define CPPMATH_MATLAB_MATCOLUMNREADER_H_
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <Eigen/Core>
+
+#include "io.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        class Inflater;
+
+        /**
+         * Reads a double matrix in blocks of columns into a buffer of the caller.
+         * MAT-files store matrices in column-major order, so a block of columns is contiguous in the file.
+         * This allows to process matrices which do not fit into memory.
+         * Compressed elements are inflated on the fly.
+         * For complex matrices the real part is read.
+         *
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatColumnReader
+        {
+        public:
+            static const std::string CLASS;
+
+            MatColumnReader();
+
+            ~MatColumnReader();
+
+            /**
+             * Prepares to read the matrix of the element, starting with the first column.
+             * The stream can be used by others between the reads.
+             *
+             * \param element Element which contains the matrix to read.
+             * \param ifs Open input stream to read from, must exist until the reader is closed.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( const ElementInfo& element, std::ifstream& ifs, const FileInfo& info );
+
+            void close();
+
+            bool isOpen() const;
+
+            size_t getRows() const;
+
+            size_t getCols() const;
+
+            /**
+             * Gets the index of the next column to read.
+             *
+             * \return Column index.
+             */
+            size_t getColumn() const;
+
+            size_t getRemainingColumns() const;
+
+            /**
+             * Reads the next columns.
+             *
+             * \param data Buffer with space for getRows() * columns values.
+             * \param columns Number of columns to read, must not exceed getRemainingColumns().
+             * \return true, if successful, false otherwise.
+             */
+            bool read( double* const data, size_t columns );
+
+            /**
+             * Reads the next columns into a reusable block, which must have getRows() rows.
+             * Fills up to block->cols() columns, the last block of a matrix may be filled partially.
+             *
+             * \param block Block to fill, is not resized.
+             * \param columns Number of read columns.
+             * \return true, if successful, false otherwise.
+             */
+            bool read( Eigen::MatrixXd* const block, size_t* const columns );
+
+            /**
+             * Skips the next columns.
+             *
+             * \param columns Number of columns to skip, must not exceed getRemainingColumns().
+             * \return true, if successful, false otherwise.
+             */
+            bool skip( size_t columns );
+
+        private:
+            MatColumnReader( const MatColumnReader& );
+
+            MatColumnReader& operator=( const MatColumnReader& );
+
+            std::ifstream* m_ifs;
+            std::unique_ptr< Inflater > m_inflater; /**< Only for compressed elements. */
+            std::streampos m_posData; /**< Stream position of the first column, if not compressed. */
+            bool m_swapBytes;
+            size_t m_rows;
+            size_t m_cols;
+            size_t m_column;
+        };
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATCOLUMNREADER_H_
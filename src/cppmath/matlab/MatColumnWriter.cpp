@@ -0,0 +1,153 @@
+#include <limits>
+#include <string>
+
+#include "../Logger.hpp"
+#include "MatColumnWriter.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatColumnWriter::CLASS = "MatColumnWriter";
+
+matlab::MatColumnWriter::MatColumnWriter() :
+                m_ofs( NULL ), m_pos( 0 ), m_posCols( 0 ), m_posData( 0 ), m_rows( 0 ), m_cols( 0 ), m_isGood( false )
+{
+}
+
+matlab::MatColumnWriter::~MatColumnWriter()
+{
+    if( isOpen() )
+    {
+        close();
+    }
+}
+
+bool matlab::MatColumnWriter::open( std::ofstream& ofs, size_t rows, const std::string& arrayName )
+{
+    if( isOpen() && !close() )
+    {
+        log::warn( CLASS ) << "Could not close previous matrix!";
+    }
+
+    if( !ofs || ofs.bad() )
+    {
+        log::error( CLASS ) << "Problem with output stream!!";
+        return false;
+    }
+    if( rows > static_cast< size_t >( std::numeric_limits< miINT32_t >::max() ) )
+    {
+        log::error( CLASS ) << "Too many rows: " << rows;
+        return false;
+    }
+
+    // Write Array Tag, Subelements and Data Tag without columns //
+    // --------------------------------------------------------- //
+    const std::streampos pos = ofs.tellp();
+    size_t writtenBytes = MatWriter::writeTagField( ofs, DataTypes::miMATRIX, 0 );
+    writtenBytes += MatWriter::writeArraySubelements( ofs, ArrayTypes::mxDOUBLE_CLASS, rows, 0, arrayName );
+    const std::streampos posData = ofs.tellp();
+    writtenBytes += MatWriter::writeTagField( ofs, DataTypes::miDOUBLE, 0 );
+    if( !ofs.good() || writtenBytes != static_cast< size_t >( ofs.tellp() - pos ) )
+    {
+        log::error( CLASS ) << "Could not write Array Tag and Subelements!";
+        ofs.clear();
+        ofs.seekp( pos );
+        return false;
+    }
+
+    m_ofs = &ofs;
+    m_pos = pos;
+    // Array Tag, Array Flags, Dimension Tag, rows
+    m_posCols = pos + static_cast< std::streamoff >( 8 + 16 + 8 + sizeof(miINT32_t) );
+    m_posData = posData;
+    m_rows = rows;
+    m_cols = 0;
+    m_isGood = true;
+    return true;
+}
+
+bool matlab::MatColumnWriter::close()
+{
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "Writer is not open!";
+        return false;
+    }
+
+    // Set correct columns and numBytes //
+    // -------------------------------- //
+    const std::streampos end = m_ofs->tellp();
+    const miINT32_t cols = m_cols;
+    const mNumBytes_t dataBytes = m_rows * m_cols * sizeof(miDouble_t);
+    const mNumBytes_t bytes = end - m_pos - static_cast< std::streamoff >( 8 );
+    m_ofs->seekp( m_pos + static_cast< std::streamoff >( sizeof(mDataType_t) ) );
+    m_ofs->write( ( char* )&bytes, sizeof(mNumBytes_t) );
+    m_ofs->seekp( m_posCols );
+    m_ofs->write( ( char* )&cols, sizeof(miINT32_t) );
+    m_ofs->seekp( m_posData + static_cast< std::streamoff >( sizeof(mDataType_t) ) );
+    m_ofs->write( ( char* )&dataBytes, sizeof(mNumBytes_t) );
+    m_ofs->seekp( end );
+
+    const bool success = m_isGood && m_ofs->good();
+    if( !success )
+    {
+        log::error( CLASS ) << "Matrix was not written completely!";
+    }
+    m_ofs = NULL;
+    m_rows = 0;
+    m_cols = 0;
+    m_isGood = false;
+    return success;
+}
+
+bool matlab::MatColumnWriter::isOpen() const
+{
+    return m_ofs != NULL;
+}
+
+size_t matlab::MatColumnWriter::getRows() const
+{
+    return m_rows;
+}
+
+size_t matlab::MatColumnWriter::getCols() const
+{
+    return m_cols;
+}
+
+bool matlab::MatColumnWriter::append( const double* const data, size_t columns )
+{
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "Writer is not open!";
+        return false;
+    }
+
+    // Check limit of numBytes for the whole element
+    const size_t headerBytes = m_posData - m_pos;
+    const size_t dataBytes = m_rows * ( m_cols + columns ) * sizeof(miDouble_t);
+    if( headerBytes + dataBytes > std::numeric_limits< mNumBytes_t >::max() )
+    {
+        log::error( CLASS ) << "Matrix exceeds the maximum element size!";
+        return false;
+    }
+
+    m_ofs->write( ( const char* )data, m_rows * columns * sizeof(miDouble_t) );
+    if( !m_ofs->good() )
+    {
+        log::error( CLASS ) << "Could not write columns!";
+        m_isGood = false;
+        return false;
+    }
+    m_cols += columns;
+    return true;
+}
+
+bool matlab::MatColumnWriter::append( const Eigen::MatrixXd& block )
+{
+    if( static_cast< size_t >( block.rows() ) != m_rows )
+    {
+        log::error( CLASS ) << "Rows of block does not match: " << block.rows() << " != " << m_rows;
+        return false;
+    }
+    return append( block.data(), block.cols() );
+}
@@ -0,0 +1,99 @@
+#ifndef CPPMATH_MATLAB_MATCOLUMNWRITER_H_
+#define CPPMATH_MATLAB_MATCOLUMNWRITER_H_
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include <Eigen/Core>
+
+#include "io.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Writes a double matrix by appending blocks of columns, e.g. for continuously produced data.
+         * The matrix element is started with zero columns. The number of columns and the number of bytes
+         * are set on close(), so the whole matrix never needs to be in memory.
+         *
+         * \attention The stream must not be used by others until the writer is closed.
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatColumnWriter
+        {
+        public:
+            static const std::string CLASS;
+
+            MatColumnWriter();
+
+            /**
+             * Closes the matrix element, if it is still open.
+             */
+            ~MatColumnWriter();
+
+            /**
+             * Starts a matrix element at the current file position.
+             *
+             * \param ofs Open output stream, must exist until the writer is closed.
+             * \param rows Number of rows of the matrix.
+             * \param arrayName Variable name.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( std::ofstream& ofs, size_t rows, const std::string& arrayName );
+
+            /**
+             * Sets the number of columns and bytes of the matrix element.
+             * If successful, file position points to the end of the written data.
+             *
+             * \return true, if successful, false otherwise.
+             */
+            bool close();
+
+            bool isOpen() const;
+
+            size_t getRows() const;
+
+            /**
+             * Gets the number of written columns.
+             *
+             * \return Number of columns.
+             */
+            size_t getCols() const;
+
+            /**
+             * Appends columns to the matrix.
+             *
+             * \param data Column-major data with getRows() * columns values.
+             * \param columns Number of columns.
+             * \return true, if successful, false otherwise.
+             */
+            bool append( const double* const data, size_t columns );
+
+            /**
+             * Appends columns to the matrix.
+             *
+             * \param block Columns with getRows() rows.
+             * \return true, if successful, false otherwise.
+             */
+            bool append( const Eigen::MatrixXd& block );
+
+        private:
+            MatColumnWriter( const MatColumnWriter& );
+
+            MatColumnWriter& operator=( const MatColumnWriter& );
+
+            std::ofstream* m_ofs;
+            std::streampos m_pos; /**< Position of the array tag. */
+            std::streampos m_posCols; /**< Position of the number of columns in the Dimension subelement. */
+            std::streampos m_posData; /**< Position of the data tag. */
+            size_t m_rows;
+            size_t m_cols;
+            bool m_isGood;
+        };
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATCOLUMNWRITER_H_
@@ -0,0 +1,171 @@
+#include <fstream>
+#include <list>
+#include <string>
+#include <utility> // make_pair
+
+#include "../Logger.hpp"
+#include "MatFile.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatFile::CLASS = "MatFile";
+
+matlab::MatFile::MatFile() :
+                m_scanPos( 128 ), m_isScanned( true )
+{
+    m_info.isMatFile = false;
+    m_info.isLittleEndian = true;
+    m_info.fileSize = 0;
+}
+
+matlab::MatFile::~MatFile()
+{
+    close();
+}
+
+bool matlab::MatFile::open( const std::string& fileName )
+{
+    close();
+
+    m_ifs.open( fileName.c_str(), std::ifstream::in | std::ifstream::binary );
+    if( !m_ifs || m_ifs.bad() )
+    {
+        log::error( CLASS ) << "Could not open file: " << fileName;
+        close();
+        return false;
+    }
+    if( !MatReader::readHeader( &m_info, m_ifs ) || !m_info.isMatFile )
+    {
+        log::error( CLASS ) << "Could not read header: " << fileName;
+        close();
+        return false;
+    }
+
+    m_scanPos = m_ifs.tellg();
+    m_isScanned = false;
+    return true;
+}
+
+void matlab::MatFile::close()
+{
+    if( m_ifs.is_open() )
+    {
+        m_ifs.close();
+    }
+    m_ifs.clear();
+    m_info.isMatFile = false;
+    m_info.fileSize = 0;
+    m_info.description.clear();
+    m_elements.clear();
+    m_elementsByName.clear();
+    m_scanPos = 128;
+    m_isScanned = true;
+}
+
+bool matlab::MatFile::isOpen() const
+{
+    return m_ifs.is_open();
+}
+
+const matlab::FileInfo& matlab::MatFile::getFileInfo() const
+{
+    return m_info;
+}
+
+const matlab::ElementInfo* matlab::MatFile::find( const std::string& name )
+{
+    const std::unordered_map< std::string, const ElementInfo* >::const_iterator it = m_elementsByName.find( name );
+    if( it != m_elementsByName.end() )
+    {
+        return it->second;
+    }
+
+    const ElementInfo* element;
+    while( ( element = scanNext() ) != NULL )
+    {
+        if( element->arrayName == name )
+        {
+            return element;
+        }
+    }
+    return NULL;
+}
+
+const std::list< matlab::ElementInfo >& matlab::MatFile::getElements()
+{
+    while( scanNext() != NULL )
+    {
+    }
+    return m_elements;
+}
+
+bool matlab::MatFile::load( Eigen::MatrixXd* const matrix, const std::string& name )
+{
+    const ElementInfo* element = find( name );
+    if( element == NULL )
+    {
+        log::error( CLASS ) << "Variable not found: " << name;
+        return false;
+    }
+    return MatReader::readMatrixDouble( matrix, *element, m_ifs, m_info );
+}
+
+bool matlab::MatFile::load( Eigen::MatrixXcd* const matrix, const std::string& name )
+{
+    const ElementInfo* element = find( name );
+    if( element == NULL )
+    {
+        log::error( CLASS ) << "Variable not found: " << name;
+        return false;
+    }
+    return MatReader::readMatrixComplex( matrix, *element, m_ifs, m_info );
+}
+
+bool matlab::MatFile::loadBlock( Eigen::MatrixXd* const block, const std::string& name, size_t startRow,
+                size_t startCol, size_t blockRows, size_t blockCols )
+{
+    const ElementInfo* element = find( name );
+    if( element == NULL )
+    {
+        log::error( CLASS ) << "Variable not found: " << name;
+        return false;
+    }
+    return MatReader::readBlock( block, startRow, startCol, blockRows, blockCols, *element, m_ifs, m_info );
+}
+
+bool matlab::MatFile::load( Eigen::SparseMatrix< double >* const matrix, const std::string& name )
+{
+    const ElementInfo* element = find( name );
+    if( element == NULL )
+    {
+        log::error( CLASS ) << "Variable not found: " << name;
+        return false;
+    }
+    return MatReader::readMatrixSparse( matrix, *element, m_ifs, m_info );
+}
+
+const matlab::ElementInfo* matlab::MatFile::scanNext()
+{
+    if( m_isScanned )
+    {
+        return NULL;
+    }
+
+    // Other reads may have moved the file position.
+    m_ifs.clear();
+    m_ifs.seekg( m_scanPos );
+    ElementInfo element;
+    if( !MatReader::readDataElement( &element, m_ifs, m_info ) )
+    {
+        m_isScanned = true;
+        m_ifs.clear();
+        return NULL;
+    }
+    m_scanPos = m_ifs.tellg();
+
+    m_elements.push_back( element );
+    const ElementInfo* const added = &m_elements.back();
+    // First element wins, e.g. for elements without a name.
+    m_elementsByName.insert( std::make_pair( added->arrayName, added ) );
+    return added;
+}
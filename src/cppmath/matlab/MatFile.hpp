@@ -0,0 +1,134 @@
+#ifndef CPPMATH_MATLAB_MATFILE_H_
+#define CPPMATH_MATLAB_MATFILE_H_
+
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include "io.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * A MAT-file with random access to its variables by name.
+         * The file is scanned lazily, i.e. only until the requested variable is found.
+         * Found elements are remembered, so the file is scanned at most once.
+         *
+         * \attention Does only supports: 2-dim double, complex and sparse matrices, blocks of double matrices.
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatFile
+        {
+        public:
+            static const std::string CLASS;
+
+            MatFile();
+
+            ~MatFile();
+
+            /**
+             * Opens the file and reads the header. A previously opened file is closed.
+             *
+             * \param fileName Path to the MAT-file.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( const std::string& fileName );
+
+            void close();
+
+            bool isOpen() const;
+
+            /**
+             * Gets the information read from the header.
+             *
+             * \return File information.
+             */
+            const FileInfo& getFileInfo() const;
+
+            /**
+             * Finds the element of a variable. Scans the file until the variable is found.
+             *
+             * \param name Variable name.
+             * \return The element or null, if there is no variable with this name.
+             */
+            const ElementInfo* find( const std::string& name );
+
+            /**
+             * Gets all elements of the file. Scans the remaining file.
+             *
+             * \return Data elements in the order of the file.
+             */
+            const std::list< ElementInfo >& getElements();
+
+            /**
+             * Reads a double matrix by its name.
+             *
+             * \param matrix Matrix to fill.
+             * \param name Variable name.
+             * \return true, if successful, false otherwise.
+             */
+            bool load( Eigen::MatrixXd* const matrix, const std::string& name );
+
+            /**
+             * Reads a complex double matrix by its name.
+             *
+             * \param matrix Matrix to fill.
+             * \param name Variable name.
+             * \return true, if successful, false otherwise.
+             */
+            bool load( Eigen::MatrixXcd* const matrix, const std::string& name );
+
+            /**
+             * Reads a block of a double matrix by its name, e.g. a time window or some channels.
+             * Only the columns of the block are read, see MatReader::readBlock().
+             *
+             * \param block Matrix to fill with blockRows x blockCols values.
+             * \param name Variable name.
+             * \param startRow First row of the block.
+             * \param startCol First column of the block.
+             * \param blockRows Number of rows of the block.
+             * \param blockCols Number of columns of the block.
+             * \return true, if successful, false otherwise.
+             */
+            bool loadBlock( Eigen::MatrixXd* const block, const std::string& name, size_t startRow, size_t startCol,
+                            size_t blockRows, size_t blockCols );
+
+            /**
+             * Reads a sparse matrix by its name.
+             *
+             * \param matrix Matrix to fill.
+             * \param name Variable name.
+             * \return true, if successful, false otherwise.
+             */
+            bool load( Eigen::SparseMatrix< double >* const matrix, const std::string& name );
+
+        private:
+            MatFile( const MatFile& );
+
+            MatFile& operator=( const MatFile& );
+
+            /**
+             * Reads the next element and adds it to the known elements.
+             *
+             * \return The element or null, if the file end is reached.
+             */
+            const ElementInfo* scanNext();
+
+            std::ifstream m_ifs;
+            FileInfo m_info;
+            std::list< ElementInfo > m_elements;
+            std::unordered_map< std::string, const ElementInfo* > m_elementsByName;
+            std::streampos m_scanPos; /**< Position of the next element to scan. */
+            bool m_isScanned;
+        };
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATFILE_H_
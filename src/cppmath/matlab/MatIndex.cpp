@@ -0,0 +1,261 @@
+#include <cstring> // memcpy
+#include <fstream>
+#include <list>
+#include <string>
+#include <utility> // make_pair
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../Logger.hpp"
+#include "MatIndex.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatIndex::CLASS = "MatIndex";
+const std::string matlab::MatIndex::SUFFIX = ".idx";
+const uint32_t matlab::MatIndex::VERSION = 3;
+
+namespace
+{
+    const char MAGIC[8] = { 'C', 'P', 'P', 'M', 'I', 'D', 'X', '\0' };
+
+    /**
+     * Header of the sidecar file, followed by the records of the elements.
+     */
+    typedef struct IndexHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+        uint64_t fileSize;
+        int64_t modified;
+    } IndexHeader;
+
+    /**
+     * Record of an element, followed by the array name and the dimensions.
+     */
+    typedef struct IndexRecord
+    {
+        uint64_t pos;
+        uint64_t posData;
+        uint32_t dataType;
+        uint32_t numBytes;
+        uint32_t arrayFlags;
+        int32_t rows;
+        int32_t cols;
+        uint32_t nzmax;
+        uint32_t nameLength;
+        uint32_t dimsLength;
+    } IndexRecord;
+}
+
+matlab::MatIndex::MatIndex() :
+                m_fileSize( 0 ), m_modified( 0 )
+{
+}
+
+bool matlab::MatIndex::open( const std::string& fileName, std::ifstream& ifs, const FileInfo& info )
+{
+    if( load( fileName ) )
+    {
+        return true;
+    }
+
+    std::list< ElementInfo > elements;
+    if( !MatReader::retrieveDataElements( &elements, ifs, info ) || !assign( fileName, elements ) )
+    {
+        clear();
+        return false;
+    }
+    if( !save( fileName ) )
+    {
+        log::warn( CLASS ) << "Could not write index for: " << fileName;
+    }
+    return true;
+}
+
+bool matlab::MatIndex::load( const std::string& fileName )
+{
+    clear();
+
+    uint64_t fileSize;
+    int64_t modified;
+    if( !getFileStatus( &fileSize, &modified, fileName ) )
+    {
+        return false;
+    }
+
+    // Read the whole sidecar file at once
+    const std::string indexFileName = getIndexFileName( fileName );
+    std::ifstream ifs( indexFileName.c_str(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate );
+    if( !ifs )
+    {
+        log::debug( CLASS ) << "No index found: " << indexFileName;
+        return false;
+    }
+    std::vector< char > buffer( static_cast< size_t >( ifs.tellg() ) );
+    ifs.seekg( 0 );
+    ifs.read( buffer.data(), buffer.size() );
+    if( !ifs || buffer.size() < sizeof(IndexHeader) )
+    {
+        log::error( CLASS ) << "Could not read index: " << indexFileName;
+        return false;
+    }
+
+    IndexHeader header;
+    memcpy( &header, buffer.data(), sizeof(IndexHeader) );
+    if( memcmp( header.magic, MAGIC, sizeof( MAGIC ) ) != 0 || header.version != VERSION )
+    {
+        log::warn( CLASS ) << "Unknown index format: " << indexFileName;
+        return false;
+    }
+    if( header.fileSize != fileSize || header.modified != modified )
+    {
+        log::debug( CLASS ) << "Index is outdated: " << indexFileName;
+        return false;
+    }
+
+    size_t pos = sizeof(IndexHeader);
+    IndexRecord record;
+    for( uint32_t i = 0; i < header.count; ++i )
+    {
+        if( pos + sizeof(IndexRecord) > buffer.size() )
+        {
+            log::error( CLASS ) << "Index is corrupted: " << indexFileName;
+            clear();
+            return false;
+        }
+        memcpy( &record, buffer.data() + pos, sizeof(IndexRecord) );
+        pos += sizeof(IndexRecord);
+        const size_t dimsBytes = record.dimsLength * sizeof(miINT32_t);
+        if( pos + record.nameLength + dimsBytes > buffer.size() )
+        {
+            log::error( CLASS ) << "Index is corrupted: " << indexFileName;
+            clear();
+            return false;
+        }
+
+        ElementInfo element;
+        element.pos = record.pos;
+        element.posData = record.posData;
+        element.dataType = record.dataType;
+        element.numBytes = record.numBytes;
+        element.arrayFlags = record.arrayFlags;
+        element.rows = record.rows;
+        element.cols = record.cols;
+        element.nzmax = record.nzmax;
+        element.arrayName.assign( buffer.data() + pos, record.nameLength );
+        pos += record.nameLength;
+        element.dims.resize( record.dimsLength );
+        memcpy( element.dims.data(), buffer.data() + pos, dimsBytes );
+        pos += dimsBytes;
+        m_elements.push_back( element );
+    }
+
+    m_fileSize = fileSize;
+    m_modified = modified;
+    createLookup();
+    log::debug( CLASS ) << "Index loaded: " << indexFileName;
+    return true;
+}
+
+bool matlab::MatIndex::save( const std::string& fileName ) const
+{
+    // Assemble the whole sidecar file to write it at once
+    IndexHeader header;
+    memcpy( header.magic, MAGIC, sizeof( MAGIC ) );
+    header.version = VERSION;
+    header.count = m_elements.size();
+    header.fileSize = m_fileSize;
+    header.modified = m_modified;
+
+    std::string buffer( ( const char* )&header, sizeof(IndexHeader) );
+    IndexRecord record;
+    for( std::list< ElementInfo >::const_iterator it = m_elements.begin(); it != m_elements.end(); ++it )
+    {
+        record.pos = it->pos;
+        record.posData = it->posData;
+        record.dataType = it->dataType;
+        record.numBytes = it->numBytes;
+        record.arrayFlags = it->arrayFlags;
+        record.rows = it->rows;
+        record.cols = it->cols;
+        record.nzmax = it->nzmax;
+        record.nameLength = it->arrayName.length();
+        record.dimsLength = it->dims.size();
+        buffer.append( ( const char* )&record, sizeof(IndexRecord) );
+        buffer.append( it->arrayName );
+        buffer.append( ( const char* )it->dims.data(), it->dims.size() * sizeof(miINT32_t) );
+    }
+
+    const std::string indexFileName = getIndexFileName( fileName );
+    std::ofstream ofs( indexFileName.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+    ofs.write( buffer.data(), buffer.size() );
+    ofs.close();
+    if( !ofs )
+    {
+        log::error( CLASS ) << "Could not write index: " << indexFileName;
+        return false;
+    }
+    return true;
+}
+
+bool matlab::MatIndex::assign( const std::string& fileName, const std::list< ElementInfo >& elements )
+{
+    clear();
+    if( !getFileStatus( &m_fileSize, &m_modified, fileName ) )
+    {
+        return false;
+    }
+    m_elements = elements;
+    createLookup();
+    return true;
+}
+
+void matlab::MatIndex::clear()
+{
+    m_elements.clear();
+    m_elementsByName.clear();
+    m_fileSize = 0;
+    m_modified = 0;
+}
+
+const matlab::ElementInfo* matlab::MatIndex::find( const std::string& name ) const
+{
+    const std::unordered_map< std::string, const ElementInfo* >::const_iterator it = m_elementsByName.find( name );
+    return it != m_elementsByName.end() ? it->second : NULL;
+}
+
+const std::list< matlab::ElementInfo >& matlab::MatIndex::getElements() const
+{
+    return m_elements;
+}
+
+std::string matlab::MatIndex::getIndexFileName( const std::string& fileName )
+{
+    return fileName + SUFFIX;
+}
+
+bool matlab::MatIndex::getFileStatus( uint64_t* const fileSize, int64_t* const modified, const std::string& fileName )
+{
+    struct stat st;
+    if( stat( fileName.c_str(), &st ) != 0 )
+    {
+        log::error( CLASS ) << "Could not get file status: " << fileName;
+        return false;
+    }
+    *fileSize = st.st_size;
+    *modified = static_cast< int64_t >( st.st_mtim.tv_sec ) * 1000000000 + st.st_mtim.tv_nsec;
+    return true;
+}
+
+void matlab::MatIndex::createLookup()
+{
+    m_elementsByName.clear();
+    for( std::list< ElementInfo >::const_iterator it = m_elements.begin(); it != m_elements.end(); ++it )
+    {
+        // First element wins, e.g. for elements without a name.
+        m_elementsByName.insert( std::make_pair( it->arrayName, &( *it ) ) );
+    }
+}
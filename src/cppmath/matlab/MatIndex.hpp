@@ -0,0 +1,117 @@
+#ifndef CPPMATH_MATLAB_MATINDEX_H_
+#define CPPMATH_MATLAB_MATINDEX_H_
+
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "io.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Index of the data elements of a MAT-file with lookup by variable name.
+         * The index can be stored in a sidecar file next to the MAT-file, so reopening a large file does not need to
+         * scan all elements. The sidecar file is invalid, if size or modification time of the MAT-file changed.
+         *
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatIndex
+        {
+        public:
+            static const std::string CLASS;
+
+            /**
+             * Suffix which is appended to the MAT-file name for the sidecar file.
+             */
+            static const std::string SUFFIX;
+
+            MatIndex();
+
+            /**
+             * Loads the index from the sidecar file, if it is valid.
+             * Otherwise the data elements are retrieved from the MAT-file and the sidecar file is written.
+             * A sidecar file which could not be written is not an error.
+             *
+             * \param fileName Path to the MAT-file.
+             * \param ifs Open input stream of the MAT-file, header must be read.
+             * \param info File information of the MAT-file.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( const std::string& fileName, std::ifstream& ifs, const FileInfo& info );
+
+            /**
+             * Loads the index from the sidecar file.
+             *
+             * \param fileName Path to the MAT-file.
+             * \return true, if the sidecar file exists and is valid for the MAT-file.
+             */
+            bool load( const std::string& fileName );
+
+            /**
+             * Writes the index to the sidecar file.
+             *
+             * \param fileName Path to the MAT-file.
+             * \return true, if successful, false otherwise.
+             */
+            bool save( const std::string& fileName ) const;
+
+            /**
+             * Sets the index from retrieved elements, e.g. from MatReader::retrieveDataElements().
+             *
+             * \param fileName Path to the MAT-file, for size and modification time.
+             * \param elements Data elements of the MAT-file.
+             * \return true, if successful, false otherwise.
+             */
+            bool assign( const std::string& fileName, const std::list< ElementInfo >& elements );
+
+            void clear();
+
+            /**
+             * Gets the element by its variable name.
+             *
+             * \param name Variable name.
+             * \return The element or null, if there is no variable with this name.
+             */
+            const ElementInfo* find( const std::string& name ) const;
+
+            /**
+             * Gets all elements in the order of the file.
+             *
+             * \return Data elements.
+             */
+            const std::list< ElementInfo >& getElements() const;
+
+            /**
+             * Gets the path of the sidecar file for the MAT-file.
+             *
+             * \param fileName Path to the MAT-file.
+             * \return Path to the sidecar file.
+             */
+            static std::string getIndexFileName( const std::string& fileName );
+
+        private:
+            MatIndex( const MatIndex& );
+
+            MatIndex& operator=( const MatIndex& );
+
+            static const uint32_t VERSION;
+
+            static bool getFileStatus( uint64_t* const fileSize, int64_t* const modified, const std::string& fileName );
+
+            void createLookup();
+
+            std::list< ElementInfo > m_elements;
+            std::unordered_map< std::string, const ElementInfo* > m_elementsByName;
+            uint64_t m_fileSize;
+            int64_t m_modified; /**< Modification time of the MAT-file in nanoseconds. */
+        };
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATINDEX_H_
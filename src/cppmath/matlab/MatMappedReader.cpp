@@ -0,0 +1,401 @@
+#include <algorithm>
+#include <cstring> // memcpy
+#include <list>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Logger.hpp"
+#include "DataSource.hpp"
+#include "MatMappedReader.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatMappedReader::CLASS = "MatMappedReader";
+
+matlab::MatMappedReader::MatMappedReader() :
+                m_data( NULL ), m_size( 0 )
+{
+    m_info.isMatFile = false;
+    m_info.isLittleEndian = true;
+    m_info.fileSize = 0;
+}
+
+matlab::MatMappedReader::~MatMappedReader()
+{
+    close();
+}
+
+bool matlab::MatMappedReader::open( const std::string& fileName )
+{
+    close();
+
+    const int fd = ::open( fileName.c_str(), O_RDONLY );
+    if( fd < 0 )
+    {
+        log::error( CLASS ) << "Could not open file: " << fileName;
+        return false;
+    }
+
+    struct stat st;
+    if( fstat( fd, &st ) != 0 )
+    {
+        log::error( CLASS ) << "Could not get file size: " << fileName;
+        ::close( fd );
+        return false;
+    }
+    m_info.fileSize = st.st_size;
+    log::debug( CLASS ) << "File size: " << m_info.fileSize;
+    if( m_info.fileSize < 128 )
+    {
+        log::error( CLASS ) << "File size is to small for a MAT file!";
+        ::close( fd );
+        return false;
+    }
+
+    // The mapping stays valid after closing the file descriptor.
+    void* data = mmap( NULL, m_info.fileSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if( data == MAP_FAILED )
+    {
+        log::error( CLASS ) << "Could not map file: " << fileName;
+        return false;
+    }
+    m_data = static_cast< const char* >( data );
+    m_size = m_info.fileSize;
+
+    if( !MatReader::readHeader( &m_info, m_data ) )
+    {
+        close();
+        return false;
+    }
+    if( !m_info.isLittleEndian )
+    {
+        log::error( CLASS ) << "Big endian can not be mapped, use MatReader instead!";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void matlab::MatMappedReader::close()
+{
+    if( m_data != NULL )
+    {
+        munmap( const_cast< char* >( m_data ), m_size );
+    }
+    m_data = NULL;
+    m_size = 0;
+    m_info.isMatFile = false;
+    m_info.fileSize = 0;
+    m_info.description.clear();
+}
+
+bool matlab::MatMappedReader::isOpen() const
+{
+    return m_data != NULL;
+}
+
+const matlab::FileInfo& matlab::MatMappedReader::getFileInfo() const
+{
+    return m_info;
+}
+
+bool matlab::MatMappedReader::retrieveDataElements( std::list< ElementInfo >* const elements ) const
+{
+    if( elements == NULL )
+    {
+        log::error( CLASS ) << "List for ElementInfo is null!";
+        return false;
+    }
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "File is not open!";
+        return false;
+    }
+
+    size_t pos = 128;
+    size_t dataPos;
+    size_t nextPos;
+    while( pos + 8 <= m_size )
+    {
+        ElementInfo element = ElementInfo();
+        element.pos = pos;
+        if( !readTagField( &element.dataType, &element.numBytes, &dataPos, &nextPos, pos ) )
+        {
+            log::error( CLASS ) << "Unknown data type or wrong data structure. Cancel retrieving!";
+            return false;
+        }
+        log::debug( CLASS ) << "Data Type: " << element.dataType;
+        log::debug( CLASS ) << "Number of Bytes: " << element.numBytes;
+
+        pos = nextPos;
+        if( ( element.dataType == DataTypes::miMATRIX || element.dataType == DataTypes::miCOMPRESSED )
+                        && !readArraySubelements( &element ) )
+        {
+            continue;
+        }
+        elements->push_back( element );
+    }
+
+    return true;
+}
+
+bool matlab::MatMappedReader::mapMatrixDouble( MatrixDoubleMapT* const matrix, const ElementInfo& element ) const
+{
+    if( matrix == NULL )
+    {
+        log::error( CLASS ) << "Matrix object is null!";
+        return false;
+    }
+
+    const miDouble_t* data;
+    if( !mapData( &data, element ) )
+    {
+        return false;
+    }
+
+    // Map has no assignment, so it is constructed in place.
+    new ( matrix ) MatrixDoubleMapT( data, element.rows, element.cols );
+    return true;
+}
+
+bool matlab::MatMappedReader::mapData( const miDouble_t** const dataOut, const ElementInfo& element ) const
+{
+    // Check some errors //
+    // ----------------- //
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "File is not open!";
+        return false;
+    }
+
+    if( m_size <= static_cast< size_t >( element.posData ) )
+    {
+        log::error( CLASS ) << "Data position is beyond file end!";
+        return false;
+    }
+
+    if( element.dataType == DataTypes::miCOMPRESSED )
+    {
+        log::error( CLASS ) << "Compressed data could not be mapped, use MatReader instead!";
+        return false;
+    }
+
+    if( element.dataType != DataTypes::miMATRIX )
+    {
+        log::error( CLASS ) << "Data type is not a matrix: " << element.dataType;
+        return false;
+    }
+
+    const mArrayType_t arrayType = ArrayFlags::getArrayType( element.arrayFlags );
+    if( arrayType != ArrayTypes::mxDOUBLE_CLASS )
+    {
+        log::error( CLASS ) << "Numeric Types does not match!";
+        return false;
+    }
+
+    // Map data //
+    // -------- //
+    mDataType_t type;
+    mNumBytes_t bytes;
+    size_t dataPos;
+    size_t nextPos;
+    if( !readTagField( &type, &bytes, &dataPos, &nextPos, element.posData ) )
+    {
+        log::error( CLASS ) << "Could not read Data Element!";
+        return false;
+    }
+    if( type != DataTypes::miDOUBLE )
+    {
+        log::error( CLASS ) << "Numeric Types does not match or compressed data, which is not supported: " << type;
+        return false;
+    }
+
+    const size_t size = static_cast< size_t >( element.rows ) * element.cols;
+    if( bytes != size * sizeof(miDouble_t) || dataPos + bytes > m_size )
+    {
+        log::error( CLASS ) << "Data size does not match the dimension: " << bytes;
+        return false;
+    }
+
+    const char* data = m_data + dataPos;
+    if( reinterpret_cast< size_t >( data ) % sizeof(miDouble_t) != 0 )
+    {
+        log::error( CLASS ) << "Data is not aligned for double, could not map matrix!";
+        return false;
+    }
+
+    *dataOut = reinterpret_cast< const miDouble_t* >( data );
+    return true;
+}
+
+bool matlab::MatMappedReader::mapMatrixSparse( SparseMatrixDoubleMapT* const matrix, const ElementInfo& element ) const
+{
+    // Check some errors //
+    // ----------------- //
+    if( matrix == NULL )
+    {
+        log::error( CLASS ) << "Matrix object is null!";
+        return false;
+    }
+
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "File is not open!";
+        return false;
+    }
+
+    if( m_size <= static_cast< size_t >( element.posData ) )
+    {
+        log::error( CLASS ) << "Data position is beyond file end!";
+        return false;
+    }
+
+    if( element.dataType != DataTypes::miMATRIX )
+    {
+        log::error( CLASS ) << "Data type is not a matrix or compressed: " << element.dataType;
+        return false;
+    }
+
+    if( ArrayFlags::getArrayType( element.arrayFlags ) != ArrayTypes::mxSPARSE_CLASS
+                    || ArrayFlags::isComplex( element.arrayFlags ) )
+    {
+        log::error( CLASS ) << "Array type is not a real sparse matrix!";
+        return false;
+    }
+
+    // Map data //
+    // -------- //
+    typedef SparseMatrixDoubleMapT::StorageIndex IndexT;
+    size_t pos = element.posData;
+    size_t irCount;
+    size_t jcCount;
+    size_t prCount;
+    const char* const ir = mapSubelement( DataTypes::miINT32, sizeof(IndexT), &irCount, &pos );
+    const char* const jc = ir ? mapSubelement( DataTypes::miINT32, sizeof(IndexT), &jcCount, &pos ) : NULL;
+    const char* const pr = jc ? mapSubelement( DataTypes::miDOUBLE, sizeof(miDouble_t), &prCount, &pos ) : NULL;
+    if( pr == NULL )
+    {
+        log::error( CLASS ) << "Sparse data is not stored as miINT32/miDOUBLE or not aligned, could not map matrix!";
+        return false;
+    }
+
+    const IndexT* const outer = reinterpret_cast< const IndexT* >( jc );
+    if( jcCount != static_cast< size_t >( element.cols ) + 1 || outer[0] != 0 )
+    {
+        log::error( CLASS ) << "Column offsets does not match the dimension!";
+        return false;
+    }
+    for( miINT32_t c = 0; c < element.cols; ++c )
+    {
+        if( outer[c] > outer[c + 1] )
+        {
+            log::error( CLASS ) << "Column offsets are not ascending!";
+            return false;
+        }
+    }
+    const IndexT nnz = outer[element.cols];
+    if( static_cast< size_t >( nnz ) > std::min( irCount, prCount ) )
+    {
+        log::error( CLASS ) << "Wrong number of non-zero elements: " << nnz;
+        return false;
+    }
+
+    // Map has no assignment, so it is constructed in place.
+    new ( matrix ) SparseMatrixDoubleMapT( element.rows, element.cols, nnz, outer,
+                    reinterpret_cast< const IndexT* >( ir ), reinterpret_cast< const miDouble_t* >( pr ) );
+    return true;
+}
+
+const char* matlab::MatMappedReader::mapSubelement( mDataType_t dataType, size_t width, size_t* const count,
+                size_t* const pos ) const
+{
+    mDataType_t type;
+    mNumBytes_t bytes;
+    size_t dataPos;
+    if( !readTagField( &type, &bytes, &dataPos, pos, *pos ) || type != dataType || bytes % width )
+    {
+        return NULL;
+    }
+    if( dataPos + bytes > m_size || ( reinterpret_cast< size_t >( m_data ) + dataPos ) % width != 0 )
+    {
+        return NULL;
+    }
+    *count = bytes / width;
+    return m_data + dataPos;
+}
+
+bool matlab::MatMappedReader::readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes,
+                size_t* const dataPos, size_t* const nextPos, size_t pos ) const
+{
+    if( pos + 8 > m_size )
+    {
+        log::error( CLASS ) << "Tag field is beyond file end!";
+        return false;
+    }
+
+    memcpy( dataType, m_data + pos, sizeof(mDataType_t) );
+    memcpy( numBytes, m_data + pos + sizeof(mDataType_t), sizeof(mNumBytes_t) );
+    if( *dataType > DataTypes::miUTF32 )
+    {
+        // Small Data Element Format: 2 bytes type, 2 bytes number of bytes and 4 bytes data.
+        mDataTypeSmall_t typeSmall;
+        mNumBytesSmall_t bytesSmall;
+        memcpy( &typeSmall, m_data + pos, sizeof(mDataTypeSmall_t) );
+        memcpy( &bytesSmall, m_data + pos + sizeof(mDataTypeSmall_t), sizeof(mNumBytesSmall_t) );
+        *dataType = typeSmall;
+        *numBytes = bytesSmall;
+        *dataPos = pos + 4;
+        *nextPos = pos + 8;
+        if( *numBytes > 4 )
+        {
+            log::error( CLASS ) << "Small data element with more than 4 bytes!";
+            return false;
+        }
+    }
+    else
+    {
+        *dataPos = pos + 8;
+        *nextPos = *dataPos + *numBytes;
+        if( *numBytes % 8 && *dataType != DataTypes::miCOMPRESSED ) // compressed data is not padded
+        {
+            *nextPos += 8 - ( *numBytes % 8 );
+        }
+    }
+    if( *dataType > DataTypes::miUTF32 )
+    {
+        log::error( CLASS ) << "Unknown data type or wrong data structure!";
+        return false;
+    }
+    return true;
+}
+
+bool matlab::MatMappedReader::readArraySubelements( ElementInfo* const element ) const
+{
+    const size_t pos = static_cast< size_t >( element->pos ) + 8;
+    if( pos + element->numBytes > m_size )
+    {
+        log::error( CLASS ) << "Element is beyond file end!";
+        return false;
+    }
+
+    // The source ends with the element, so no subelement is read beyond it.
+    MemorySource source( m_data + pos, element->numBytes );
+    if( element->dataType == DataTypes::miCOMPRESSED )
+    {
+        return MatReader::readCompressedSubelements( element, &source, false );
+    }
+
+    size_t numBytes;
+    if( !MatReader::readSubelements( element, &source, false, &numBytes ) )
+    {
+        return false;
+    }
+    element->posData = pos + numBytes;
+    return true;
+}
@@ -0,0 +1,161 @@
+#ifndef CPPMATH_MATLAB_MATMAPPEDREADER_H_
+#define CPPMATH_MATLAB_MATMAPPEDREADER_H_
+
+#include <cstddef>
+#include <list>
+#include <new>
+#include <string>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+#include "io.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Reader for MAT-file format, which maps the whole file into memory.
+         * Matrices are accessed as views on the mapped file, i.e. without copying and heap allocation.
+         * A view is valid as long as the file is open.
+         *
+         * \attention Does only supports: little endian, double arrays, no compression.
+         *            Compressed elements are retrieved with their array information, but must be read with MatReader.
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatMappedReader
+        {
+        public:
+            static const std::string CLASS;
+
+            typedef Eigen::Map< const Eigen::MatrixXd > MatrixDoubleMapT;
+
+            typedef Eigen::Map< const Eigen::SparseMatrix< double > > SparseMatrixDoubleMapT;
+
+            MatMappedReader();
+
+            ~MatMappedReader();
+
+            /**
+             * Maps the file and reads the header. A previously opened file is closed.
+             *
+             * \param fileName Path to the MAT-file.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( const std::string& fileName );
+
+            /**
+             * Unmaps the file. All views become invalid.
+             */
+            void close();
+
+            bool isOpen() const;
+
+            /**
+             * Gets the information read from the header.
+             *
+             * \return File information.
+             */
+            const FileInfo& getFileInfo() const;
+
+            /**
+             * Retrieves all data elements in the file.
+             *
+             * \param elements List to store found elements.
+             * \return true, if successful, false otherwise.
+             */
+            bool retrieveDataElements( std::list< ElementInfo >* const elements ) const;
+
+            /**
+             * Maps the matrix which is contained by the element, no data is copied.
+             * Fails, if the data is not stored as miDOUBLE or is not aligned to double.
+             * In this case MatReader::readMatrixDouble() can be used.
+             *
+             * \param matrix View to set, e.g. "MatrixDoubleMapT matrix( NULL, 0, 0 )".
+             * \param element Element which contains the matrix to map.
+             * \return true, if successful, false otherwise.
+             */
+            bool mapMatrixDouble( MatrixDoubleMapT* const matrix, const ElementInfo& element ) const;
+
+            /**
+             * Maps the row indices (ir), column offsets (jc) and values (pr) of a sparse matrix, no data is copied.
+             * Fails, if ir/jc are not stored as miINT32 or pr is not stored as miDOUBLE.
+             * In this case MatReader::readMatrixSparse() can be used.
+             * The column offsets are checked, the row indices are not to keep the pages of the file untouched.
+             *
+             * \param matrix View to set, e.g. "SparseMatrixDoubleMapT matrix( 0, 0, 0, NULL, NULL, NULL )".
+             * \param element Element which contains the sparse matrix to map.
+             * \return true, if successful, false otherwise.
+             */
+            bool mapMatrixSparse( SparseMatrixDoubleMapT* const matrix, const ElementInfo& element ) const;
+
+            /**
+             * Maps the n-dim double array which is contained by the element as tensor of rank N, no data is copied.
+             * Singleton dimensions may be added to or removed from the end, see MatReader::readTensor().
+             *
+             * \param tensor View to set, e.g. "TensorMap< const Tensor< double, 3 > > t( NULL, 0, 0, 0 )".
+             * \param element Element which contains the array to map.
+             * \return true, if successful, false otherwise.
+             */
+            template< int N >
+            bool mapTensor( Eigen::TensorMap< const Eigen::Tensor< double, N > >* const tensor,
+                            const ElementInfo& element ) const;
+
+        private:
+            MatMappedReader( const MatMappedReader& );
+
+            MatMappedReader& operator=( const MatMappedReader& );
+
+            /**
+             * Reads the tag field at pos and returns the position of the data and of the next element.
+             */
+            bool readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes, size_t* const dataPos,
+                            size_t* const nextPos, size_t pos ) const;
+
+            bool readArraySubelements( ElementInfo* const element ) const;
+
+            /**
+             * Gets the data of a double array, if it is stored as aligned miDOUBLE.
+             */
+            bool mapData( const miDouble_t** const data, const ElementInfo& element ) const;
+
+            /**
+             * Gets the data of the numeric subelement at pos, if it has the data type and is aligned.
+             * Moves pos to the next subelement.
+             */
+            const char* mapSubelement( mDataType_t dataType, size_t width, size_t* const count,
+                            size_t* const pos ) const;
+
+            const char* m_data;
+            size_t m_size;
+            FileInfo m_info;
+        };
+
+        template< int N >
+        inline bool MatMappedReader::mapTensor( Eigen::TensorMap< const Eigen::Tensor< double, N > >* const tensor,
+                        const ElementInfo& element ) const
+        {
+            if( tensor == NULL )
+            {
+                log::error( CLASS ) << "Tensor object is null!";
+                return false;
+            }
+
+            Eigen::array< Eigen::Index, N > dims;
+            const miDouble_t* data;
+            if( !MatReader::getTensorDimensions( dims.data(), N, element ) || !mapData( &data, element ) )
+            {
+                return false;
+            }
+
+            // Map has no assignment, so it is constructed in place.
+            new ( tensor ) Eigen::TensorMap< const Eigen::Tensor< double, N > >( data, dims );
+            return true;
+        }
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATMAPPEDREADER_H_
@@ -0,0 +1,378 @@
+#include <list>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Logger.hpp"
+#include "Compression.hpp"
+#include "DataSource.hpp"
+#include "MatPReader.hpp"
+
+using namespace cppmath;
+
+const std::string matlab::MatPReader::CLASS = "MatPReader";
+
+matlab::MatPReader::MatPReader() :
+                m_fd( -1 )
+{
+    m_info.isMatFile = false;
+    m_info.isLittleEndian = true;
+    m_info.fileSize = 0;
+}
+
+matlab::MatPReader::~MatPReader()
+{
+    close();
+}
+
+bool matlab::MatPReader::open( const std::string& fileName )
+{
+    close();
+
+    m_fd = ::open( fileName.c_str(), O_RDONLY );
+    if( m_fd < 0 )
+    {
+        log::error( CLASS ) << "Could not open file: " << fileName;
+        return false;
+    }
+
+    struct stat st;
+    if( fstat( m_fd, &st ) != 0 )
+    {
+        log::error( CLASS ) << "Could not get file size: " << fileName;
+        close();
+        return false;
+    }
+    m_info.fileSize = st.st_size;
+    log::debug( CLASS ) << "File size: " << m_info.fileSize;
+    if( m_info.fileSize < 128 )
+    {
+        log::error( CLASS ) << "File size is to small for a MAT file!";
+        close();
+        return false;
+    }
+
+    char header[128];
+    PositionalSource source( m_fd, 0 );
+    if( !source.read( header, 128 ) )
+    {
+        log::error( CLASS ) << "Could not read header!";
+        close();
+        return false;
+    }
+
+    if( !MatReader::readHeader( &m_info, header ) )
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void matlab::MatPReader::close()
+{
+    if( m_fd >= 0 )
+    {
+        ::close( m_fd );
+    }
+    m_fd = -1;
+    m_info.isMatFile = false;
+    m_info.fileSize = 0;
+    m_info.description.clear();
+}
+
+bool matlab::MatPReader::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+const matlab::FileInfo& matlab::MatPReader::getFileInfo() const
+{
+    return m_info;
+}
+
+bool matlab::MatPReader::retrieveDataElements( std::list< ElementInfo >* const elements ) const
+{
+    if( elements == NULL )
+    {
+        log::error( CLASS ) << "List for ElementInfo is null!";
+        return false;
+    }
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "File is not open!";
+        return false;
+    }
+
+    size_t pos = 128;
+    size_t nextPos;
+    while( pos + 8 <= m_info.fileSize )
+    {
+        ElementInfo element;
+        element.pos = pos;
+        if( !readTagField( &element.dataType, &element.numBytes, &nextPos, pos ) )
+        {
+            log::error( CLASS ) << "Unknown data type or wrong data structure. Cancel retrieving!";
+            return false;
+        }
+        log::debug( CLASS ) << "Data Type: " << element.dataType;
+        log::debug( CLASS ) << "Number of Bytes: " << element.numBytes;
+
+        pos = nextPos;
+        const bool isArray = element.dataType == DataTypes::miMATRIX
+                        || element.dataType == DataTypes::miCOMPRESSED;
+        if( isArray && !readArraySubelements( &element ) )
+        {
+            continue;
+        }
+        elements->push_back( element );
+    }
+
+    return true;
+}
+
+bool matlab::MatPReader::readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes,
+                size_t* const nextPos, size_t pos ) const
+{
+    mDataType_t tag[2];
+    PositionalSource source( m_fd, pos );
+    if( !source.read( tag, sizeof( tag ) ) )
+    {
+        return false;
+    }
+    if( ByteOrder::isSwapped( m_info ) )
+    {
+        ByteOrder::swap( tag, 2, sizeof(mDataType_t) );
+    }
+
+    if( tag[0] > DataTypes::miUTF32 )
+    {
+        // Small Data Element Format, number of bytes in the upper and type in the lower 2 bytes.
+        *dataType = static_cast< mDataTypeSmall_t >( tag[0] & 0xFFFF );
+        *numBytes = static_cast< mNumBytesSmall_t >( tag[0] >> 16 );
+        *nextPos = pos + 8;
+    }
+    else
+    {
+        *dataType = tag[0];
+        *numBytes = tag[1];
+        *nextPos = pos + 8 + *numBytes;
+        // Compressed data is not padded.
+        if( *dataType != DataTypes::miCOMPRESSED && *numBytes % 8 )
+        {
+            *nextPos += 8 - ( *numBytes % 8 );
+        }
+    }
+    return *dataType <= DataTypes::miUTF32;
+}
+
+bool matlab::MatPReader::readArraySubelements( ElementInfo* const element ) const
+{
+    const bool swapBytes = ByteOrder::isSwapped( m_info );
+    PositionalSource source( m_fd, static_cast< size_t >( element->pos ) + 8 );
+    size_t numBytes;
+    if( element->dataType == DataTypes::miCOMPRESSED )
+    {
+        return MatReader::readCompressedSubelements( element, &source, swapBytes );
+    }
+
+    if( !MatReader::readSubelements( element, &source, swapBytes, &numBytes ) )
+    {
+        return false;
+    }
+    element->posData = static_cast< size_t >( element->pos ) + 8 + numBytes;
+    return true;
+}
+
+bool matlab::MatPReader::checkNumericArray( const ElementInfo& element ) const
+{
+    if( !isOpen() )
+    {
+        log::error( CLASS ) << "File is not open!";
+        return false;
+    }
+
+    const bool isCompressed = element.dataType == DataTypes::miCOMPRESSED;
+    if( !isCompressed && m_info.fileSize <= static_cast< size_t >( element.posData ) )
+    {
+        log::error( CLASS ) << "Data position is beyond file end!";
+        return false;
+    }
+
+    if( element.dataType != DataTypes::miMATRIX && !isCompressed )
+    {
+        log::error( CLASS ) << "Data type is not a matrix: " << element.dataType;
+        return false;
+    }
+
+    const mArrayType_t arrayType = ArrayFlags::getArrayType( element.arrayFlags );
+    if( !ArrayTypes::isNumericArray( arrayType ) )
+    {
+        log::error( CLASS ) << "Array type is not numeric: " << ( int )arrayType;
+        return false;
+    }
+    return true;
+}
+
+template< typename T >
+bool matlab::MatPReader::readData( T* const data, size_t size, const ElementInfo& element ) const
+{
+    if( data == NULL && size > 0 )
+    {
+        log::error( CLASS ) << "Data is null!";
+        return false;
+    }
+    if( !checkNumericArray( element ) )
+    {
+        return false;
+    }
+
+    const bool swapBytes = ByteOrder::isSwapped( m_info );
+    bool success;
+    if( element.dataType == DataTypes::miCOMPRESSED )
+    {
+        // Inflate directly into the destination.
+        PositionalSource source( m_fd, static_cast< size_t >( element.pos ) + 8 );
+        Inflater inflater( &source, element.numBytes );
+        success = inflater.skip( static_cast< size_t >( element.posData ) )
+                        && readNumericData( data, size, &inflater, swapBytes );
+    }
+    else
+    {
+        PositionalSource source( m_fd, static_cast< size_t >( element.posData ) );
+        success = readNumericData( data, size, &source, swapBytes );
+    }
+
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read array data!";
+        return false;
+    }
+    return true;
+}
+
+template bool matlab::MatPReader::readData< double >( double* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< float >( float* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< int8_t >( int8_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< uint8_t >( uint8_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< int16_t >( int16_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< uint16_t >( uint16_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< int32_t >( int32_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< uint32_t >( uint32_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< int64_t >( int64_t* const, size_t, const ElementInfo& ) const;
+template bool matlab::MatPReader::readData< uint64_t >( uint64_t* const, size_t, const ElementInfo& ) const;
+
+template< typename T >
+bool matlab::MatPReader::readBlockData( T* const data, size_t startRow, size_t startCol, size_t blockRows,
+                size_t blockCols, const ElementInfo& element ) const
+{
+    if( data == NULL && blockRows * blockCols > 0 )
+    {
+        log::error( CLASS ) << "Data is null!";
+        return false;
+    }
+    if( !checkNumericArray( element ) )
+    {
+        return false;
+    }
+
+    const bool swapBytes = ByteOrder::isSwapped( m_info );
+    bool success;
+    if( element.dataType == DataTypes::miCOMPRESSED )
+    {
+        // Compressed data can not be seeked, the data in front of the block is inflated and discarded.
+        PositionalSource source( m_fd, static_cast< size_t >( element.pos ) + 8 );
+        Inflater inflater( &source, element.numBytes );
+        success = inflater.skip( static_cast< size_t >( element.posData ) )
+                        && readNumericBlock( data, element.rows, element.cols, startRow, startCol, blockRows,
+                                        blockCols, &inflater, swapBytes );
+    }
+    else
+    {
+        PositionalSource source( m_fd, static_cast< size_t >( element.posData ) );
+        success = readNumericBlock( data, element.rows, element.cols, startRow, startCol, blockRows, blockCols,
+                        &source, swapBytes );
+    }
+
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read block!";
+        return false;
+    }
+    return true;
+}
+
+template bool matlab::MatPReader::readBlockData< double >( double* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< float >( float* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< int8_t >( int8_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< uint8_t >( uint8_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< int16_t >( int16_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< uint16_t >( uint16_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< int32_t >( int32_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< uint32_t >( uint32_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< int64_t >( int64_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+template bool matlab::MatPReader::readBlockData< uint64_t >( uint64_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo& ) const;
+
+bool matlab::MatPReader::readMatrixDouble( Eigen::MatrixXd* const matrix, const ElementInfo& element ) const
+{
+    return readMatrix( matrix, element );
+}
+
+bool matlab::MatPReader::readMatrixComplex( Eigen::MatrixXcd* const matrix, const ElementInfo& element ) const
+{
+    if( matrix == NULL )
+    {
+        log::error( CLASS ) << "Matrix object is null!";
+        return false;
+    }
+    if( !checkNumericArray( element ) )
+    {
+        return false;
+    }
+    if( !ArrayFlags::isComplex( element.arrayFlags ) )
+    {
+        log::error( CLASS ) << "Numeric Types does not match!";
+        return false;
+    }
+
+    // Real and imaginary part are read directly into the interleaved storage of the complex matrix.
+    matrix->resize( element.rows, element.cols );
+    double* const real = reinterpret_cast< double* >( matrix->data() );
+    double* const imag = real + 1;
+    const bool swapBytes = ByteOrder::isSwapped( m_info );
+    bool success;
+    if( element.dataType == DataTypes::miCOMPRESSED )
+    {
+        PositionalSource source( m_fd, static_cast< size_t >( element.pos ) + 8 );
+        Inflater inflater( &source, element.numBytes );
+        success = inflater.skip( static_cast< size_t >( element.posData ) )
+                        && readNumericDataInterleaved( real, matrix->size(), &inflater, swapBytes )
+                        && readNumericDataInterleaved( imag, matrix->size(), &inflater, swapBytes );
+    }
+    else
+    {
+        PositionalSource source( m_fd, static_cast< size_t >( element.posData ) );
+        success = readNumericDataInterleaved( real, matrix->size(), &source, swapBytes )
+                        && readNumericDataInterleaved( imag, matrix->size(), &source, swapBytes );
+    }
+
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read real or imag data!";
+        return false;
+    }
+    return true;
+}
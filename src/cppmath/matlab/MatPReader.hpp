@@ -0,0 +1,219 @@
+#ifndef CPPMATH_MATLAB_MATPREADER_H_
+#define CPPMATH_MATLAB_MATPREADER_H_
+
+#include <cstddef>
+#include <list>
+#include <string>
+
+#include <Eigen/Core>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+#include "io.hpp"
+
+namespace cppmath
+{
+    namespace matlab
+    {
+        /**
+         * Reader for MAT-file format, which uses positional reads (pread) on a file descriptor.
+         * There is no shared file position, so all const methods can be called concurrently without locks,
+         * e.g. to read different variables of one file by several threads.
+         * Compressed elements are inflated on the fly, files with a different byte order are swapped.
+         * open() and close() must not be called concurrently with reads.
+         *
+         * \attention Does only supports: numeric arrays, no sparse matrices.
+         * \author cpieloth
+         * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+         */
+        class MatPReader
+        {
+        public:
+            static const std::string CLASS;
+
+            MatPReader();
+
+            ~MatPReader();
+
+            /**
+             * Opens the file and reads the header. A previously opened file is closed.
+             *
+             * \param fileName Path to the MAT-file.
+             * \return true, if successful, false otherwise.
+             */
+            bool open( const std::string& fileName );
+
+            void close();
+
+            bool isOpen() const;
+
+            /**
+             * Gets the information read from the header.
+             *
+             * \return File information.
+             */
+            const FileInfo& getFileInfo() const;
+
+            /**
+             * Retrieves all data elements in the file.
+             *
+             * \param elements List to store found elements.
+             * \return true, if successful, false otherwise.
+             */
+            bool retrieveDataElements( std::list< ElementInfo >* const elements ) const;
+
+            /**
+             * Reads the numeric matrix which is contained by the element and converts it to T,
+             * see MatReader::readMatrix().
+             *
+             * \param matrix Matrix to fill.
+             * \param element Element which contains the matrix to read.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            bool readMatrix( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const matrix,
+                            const ElementInfo& element ) const;
+
+            /**
+             * Reads the n-dim numeric array which is contained by the element as tensor of rank N,
+             * see MatReader::readTensor().
+             *
+             * \param tensor Tensor to fill.
+             * \param element Element which contains the array to read.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T, int N >
+            bool readTensor( Eigen::Tensor< T, N >* const tensor, const ElementInfo& element ) const;
+
+            /**
+             * Reads the data of a numeric array into a buffer, see MatReader::readData().
+             * Available for T: double, float, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t.
+             *
+             * \param data Destination with space for size values.
+             * \param size Number of values, must match the number of elements of the array.
+             * \param element Element which contains the array to read.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            bool readData( T* const data, size_t size, const ElementInfo& element ) const;
+
+            /**
+             * Reads a block of the numeric matrix which is contained by the element, see MatReader::readBlock().
+             *
+             * \param block Matrix to fill with blockRows x blockCols values.
+             * \param startRow First row of the block.
+             * \param startCol First column of the block.
+             * \param blockRows Number of rows of the block.
+             * \param blockCols Number of columns of the block.
+             * \param element Element which contains the matrix to read.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            bool readBlock( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const block, size_t startRow,
+                            size_t startCol, size_t blockRows, size_t blockCols, const ElementInfo& element ) const;
+
+            /**
+             * Reads a block of the numeric data of the element in column-major order, see MatReader::readBlock().
+             *
+             * \param data Destination with space for blockRows * blockCols values.
+             * \param startRow First row of the block.
+             * \param startCol First column of the block.
+             * \param blockRows Number of rows of the block.
+             * \param blockCols Number of columns of the block.
+             * \param element Element which contains the array to read.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            bool readBlockData( T* const data, size_t startRow, size_t startCol, size_t blockRows, size_t blockCols,
+                            const ElementInfo& element ) const;
+
+            /**
+             * Reads the matrix which is contained by the element.
+             *
+             * \param matrix Matrix to fill.
+             * \param element Element which contains the matrix to read.
+             * \return true, if successful, false otherwise.
+             */
+            bool readMatrixDouble( Eigen::MatrixXd* const matrix, const ElementInfo& element ) const;
+
+            /**
+             * Reads the complex matrix which is contained by the element.
+             * The real and imaginary part are read directly into the interleaved complex values.
+             *
+             * \param matrix Matrix to fill.
+             * \param element Element which contains the matrix to read.
+             * \return true, if successful, false otherwise.
+             */
+            bool readMatrixComplex( Eigen::MatrixXcd* const matrix, const ElementInfo& element ) const;
+
+        private:
+            MatPReader( const MatPReader& );
+
+            MatPReader& operator=( const MatPReader& );
+
+            /**
+             * Reads the tag field at pos and returns the position of the next element.
+             */
+            bool readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes, size_t* const nextPos,
+                            size_t pos ) const;
+
+            /**
+             * Reads the subelements of a miMATRIX or miCOMPRESSED element and sets the data position.
+             */
+            bool readArraySubelements( ElementInfo* const element ) const;
+
+            /**
+             * Checks that the element contains a numeric array, which can be read.
+             */
+            bool checkNumericArray( const ElementInfo& element ) const;
+
+            int m_fd;
+            FileInfo m_info;
+        };
+
+        template< typename T >
+        inline bool MatPReader::readMatrix( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const matrix,
+                        const ElementInfo& element ) const
+        {
+            if( matrix == NULL )
+            {
+                log::error( CLASS ) << "Matrix object is null!";
+                return false;
+            }
+            matrix->resize( element.rows, element.cols );
+            return readData( matrix->data(), matrix->size(), element );
+        }
+
+        template< typename T >
+        inline bool MatPReader::readBlock( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const block,
+                        size_t startRow, size_t startCol, size_t blockRows, size_t blockCols,
+                        const ElementInfo& element ) const
+        {
+            if( block == NULL )
+            {
+                log::error( CLASS ) << "Matrix object is null!";
+                return false;
+            }
+            block->resize( blockRows, blockCols );
+            return readBlockData( block->data(), startRow, startCol, blockRows, blockCols, element );
+        }
+
+        template< typename T, int N >
+        inline bool MatPReader::readTensor( Eigen::Tensor< T, N >* const tensor, const ElementInfo& element ) const
+        {
+            if( tensor == NULL )
+            {
+                log::error( CLASS ) << "Tensor object is null!";
+                return false;
+            }
+            Eigen::array< Eigen::Index, N > dims;
+            if( !MatReader::getTensorDimensions( dims.data(), N, element ) )
+            {
+                return false;
+            }
+            tensor->resize( dims );
+            return readData( tensor->data(), tensor->size(), element );
+        }
+    } /* namespace matlab */
+} /* namespace cppmath */
+
+#endif  // CPPMATH_MATLAB_MATPREADER_H_
@@ -1,12 +1,88 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring> // memcpy
+#include <functional>
+#include <limits>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <utility> // make_pair, swap
+#include <vector>
 
+#include "../concurrent/ThreadPool.hpp"
 #include "../Logger.hpp"
+#include "Compression.hpp"
+#include "DataSource.hpp"
 #include "io.hpp"
 
 using std::ifstream;
 using namespace cppmath;
 
+namespace
+{
+    /**
+     * Reads a tag in regular format, i.e. data type and number of bytes.
+     */
+    bool readTag( matlab::mDataType_t* const tag, matlab::DataSource* const source, bool swapBytes )
+    {
+        if( !source->read( tag, 8 ) )
+        {
+            return false;
+        }
+        if( swapBytes )
+        {
+            matlab::ByteOrder::swap( tag, 2, sizeof(matlab::mDataType_t) );
+        }
+        return true;
+    }
+
+    /**
+     * Reads ir, jc and pr into the compressed storage of a matrix with nzmax non-zeros and checks the structure.
+     */
+    bool readSparseData( Eigen::SparseMatrix< double >* const matrix, size_t nzmax, matlab::DataSource* const source,
+                    bool swapBytes )
+    {
+        typedef Eigen::SparseMatrix< double >::StorageIndex IndexT;
+        IndexT* const ir = matrix->innerIndexPtr();
+        IndexT* const jc = matrix->outerIndexPtr();
+        const IndexT rows = matrix->rows();
+        const IndexT cols = matrix->cols();
+        size_t irCount = 0;
+        size_t prCount = 0;
+        if( !matlab::readNumericData( ir, nzmax, source, swapBytes, &irCount )
+                        || !matlab::readNumericData( jc, cols + 1, source, swapBytes )
+                        || !matlab::readNumericData( matrix->valuePtr(), nzmax, source, swapBytes, &prCount ) )
+        {
+            return false;
+        }
+
+        const IndexT nnz = jc[cols];
+        if( jc[0] != 0 || nnz < 0 || static_cast< size_t >( nnz ) > std::min( irCount, prCount ) )
+        {
+            log::error( matlab::MatReader::CLASS ) << "Wrong number of non-zero elements: " << nnz;
+            return false;
+        }
+        for( IndexT c = 0; c < cols; ++c )
+        {
+            if( jc[c] > jc[c + 1] )
+            {
+                log::error( matlab::MatReader::CLASS ) << "Column offsets are not ascending!";
+                return false;
+            }
+        }
+        for( IndexT i = 0; i < nnz; ++i )
+        {
+            if( ir[i] < 0 || ir[i] >= rows )
+            {
+                log::error( matlab::MatReader::CLASS ) << "Row index is out of range: " << ir[i];
+                return false;
+            }
+        }
+        matrix->resizeNonZeros( nnz );
+        return true;
+    }
+}
+
 const std::string matlab::MatReader::CLASS = "MatReader";
 
 bool matlab::MatReader::readHeader( FileInfo* const infoIn, std::ifstream& ifs )
@@ -33,7 +109,7 @@ bool matlab::MatReader::readHeader( FileInfo* const infoIn, std::ifstream& ifs )
     const ifstream::pos_type file_size = ifs.tellg();
     infoIn->fileSize = file_size;
     log::debug( CLASS ) << "File size: " << infoIn->fileSize;
-    if( file_size < 127 )
+    if( file_size < 128 )
     {
         log::error( CLASS ) << "File size is to small for a MAT file!";
         ifs.seekg( 0, ifs.beg );
@@ -41,38 +117,43 @@ bool matlab::MatReader::readHeader( FileInfo* const infoIn, std::ifstream& ifs )
     }
     ifs.seekg( 0, ifs.beg );
 
-    // Read description text
-    char description[117];
-    ifs.read( description, 116 );
-    description[116] = '\0';
-    infoIn->description.assign( description );
-    log::debug( CLASS ) << description;
-
-    // Read version
-    ifs.seekg( 8, ifstream::cur );
-    char version[2] = { 0 };
-    ifs.read( version, 2 );
-    if( version[0] != 0x00 || version[1] != 0x01 )
+    char header[128];
+    ifs.read( header, 128 );
+    if( !ifs.good() || !readHeader( infoIn, header ) )
     {
-        log::error( CLASS ) << "Wrong version!";
+        ifs.clear();
         ifs.seekg( 0, ifs.beg );
         return false;
     }
-    infoIn->isMatFile = true;
 
-    // Read endian indicator
-    char endian[2] = { 0 };
-    ifs.read( endian, 2 );
-    if( endian[0] == 'I' && endian[1] == 'M' )
+    ifs.seekg( 128 );
+
+    return true;
+}
+
+bool matlab::MatReader::readHeader( FileInfo* const info, const char* const header )
+{
+    info->isMatFile = false;
+
+    // Read description text
+    char description[117];
+    memcpy( description, header, 116 );
+    description[116] = '\0';
+    info->description.assign( description );
+    log::debug( CLASS ) << description;
+
+    // Read version and endian indicator
+    char version[2] = { header[124], header[125] };
+    if( header[126] == 'I' && header[127] == 'M' )
     {
-        infoIn->isLittleEndian = true;
+        info->isLittleEndian = true;
     }
     else
-        if( endian[0] == 'M' && endian[1] == 'I' )
+        if( header[126] == 'M' && header[127] == 'I' )
         {
-            infoIn->isLittleEndian = false;
-            log::error( CLASS ) << "Big endian is not yet supported!";
-            return false;
+            info->isLittleEndian = false;
+            // Version is written in the byte order of the file.
+            std::swap( version[0], version[1] );
         }
         else
         {
@@ -80,8 +161,13 @@ bool matlab::MatReader::readHeader( FileInfo* const infoIn, std::ifstream& ifs )
             return false;
         }
 
-    ifs.seekg( 128 );
-
+    if( version[0] != 0x00 || version[1] != 0x01 )
+    {
+        log::error( CLASS ) << "Wrong version!";
+        return false;
+    }
+    info->isMatFile = true;
+    log::debug( CLASS ) << "Little endian: " << info->isLittleEndian;
     return true;
 }
 
@@ -95,63 +181,97 @@ bool matlab::MatReader::retrieveDataElements( std::list< ElementInfo >* const el
     }
     ifs.seekg( 128 );
 
-    // Temporary data to write to
-    matlab::mDataType_t type;
-    matlab::mNumBytes_t bytes;
-    std::streampos pos;
+    ElementInfo element;
+    while( readDataElement( &element, ifs, info ) )
+    {
+        elements->push_back( element );
+    }
+
+    const std::streamoff min_tag_size = 4;
+    const bool isEnd = !ifs.good() || static_cast< size_t >( ifs.tellg() + min_tag_size ) >= info.fileSize;
+    ifs.clear();
+    ifs.seekg( 128 );
+    if( !isEnd )
+    {
+        log::error( CLASS ) << "Unknown data type or wrong data structure. Cancel retrieving!";
+        return false;
+    }
+    return true;
+}
+
+bool matlab::MatReader::readDataElement( ElementInfo* const element, std::ifstream& ifs, const FileInfo& info )
+{
+    if( element == NULL )
+    {
+        log::error( CLASS ) << "ElementInfo is null!";
+        return false;
+    }
+
+    const bool swapBytes = ByteOrder::isSwapped( info );
     const std::streamoff min_tag_size = 4;
     while( ifs.good() && static_cast< size_t >( ifs.tellg() + min_tag_size ) < info.fileSize )
     {
-        type = 0;
-        bytes = 0;
-        pos = ifs.tellg();
-        if( !readTagField( &type, &bytes, ifs ) )
+        *element = ElementInfo();
+        element->pos = ifs.tellg();
+        if( !readTagField( &element->dataType, &element->numBytes, ifs, swapBytes ) )
         {
-            log::error( CLASS ) << "Unknown data type or wrong data structure. Cancel retrieving!";
-            ifs.seekg( 128 );
             return false;
         }
+        log::debug( CLASS ) << "Data Type: " << element->dataType;
+        log::debug( CLASS ) << "Number of Bytes: " << element->numBytes;
 
-        ElementInfo element;
-        element.dataType = type;
-        element.numBytes = bytes;
-        element.pos = pos;
-        log::debug( CLASS ) << "Data Type: " << element.dataType;
-        log::debug( CLASS ) << "Number of Bytes: " << element.numBytes;
+        if( element->dataType == matlab::DataTypes::miCOMPRESSED )
+        {
+            // Compressed data is not padded.
+            StreamSource source( ifs );
+            const bool success = readCompressedSubelements( element, &source, swapBytes );
+            ifs.clear();
+            ifs.seekg( element->pos + static_cast< std::streamoff >( 8 + element->numBytes ) );
+            if( success )
+            {
+                return true;
+            }
+            continue;
+        }
 
-        if( element.dataType == matlab::DataTypes::miMATRIX )
+        if( element->dataType == matlab::DataTypes::miMATRIX )
         {
-            if( !readArraySubelements( &element, ifs ) )
+            StreamSource source( ifs );
+            size_t numBytes;
+            if( !readSubelements( element, &source, swapBytes, &numBytes ) || numBytes > element->numBytes )
             {
-                nextElement( ifs, element.pos, element.numBytes );
+                ifs.clear();
+                nextElement( ifs, element->pos, element->numBytes );
                 continue;
             }
+            element->posData = element->pos + static_cast< std::streamoff >( 8 + numBytes );
         }
 
-        nextElement( ifs, element.pos, element.numBytes );
-        elements->push_back( element );
+        nextElement( ifs, element->pos, element->numBytes );
+        return true;
     }
-
-    ifs.clear();
-    ifs.seekg( 128 );
-    return true;
+    return false;
 }
 
-bool matlab::MatReader::readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes, std::ifstream& ifs )
+bool matlab::MatReader::readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes, std::ifstream& ifs,
+                bool swapBytes )
 {
     const std::streampos pos = ifs.tellg();
-    ifs.read( ( char* )dataType, sizeof(matlab::mDataType_t) );
-    ifs.read( ( char* )numBytes, sizeof(matlab::mNumBytes_t) );
+    mDataType_t tag[2];
+    ifs.read( ( char* )tag, sizeof( tag ) );
+    if( swapBytes )
+    {
+        ByteOrder::swap( tag, 2, sizeof(mDataType_t) );
+    }
+    *dataType = tag[0];
+    *numBytes = tag[1];
     if( *dataType > matlab::DataTypes::miUTF32 )
     {
         log::debug( CLASS ) << "Small Data Element Format found.";
-        matlab::mDataTypeSmall_t typeSmall;
-        matlab::mNumBytesSmall_t bytesSmall;
-        ifs.seekg( -( sizeof(matlab::mDataType_t) + sizeof(matlab::mNumBytes_t) ), ifstream::cur );
-        ifs.read( ( char* )&typeSmall, sizeof(matlab::mDataTypeSmall_t) );
-        ifs.read( ( char* )&bytesSmall, sizeof(matlab::mNumBytesSmall_t) );
-        *dataType = typeSmall;
-        *numBytes = bytesSmall;
+        // Number of bytes in the upper and type in the lower 2 bytes, independent of the byte order.
+        *dataType = static_cast< mDataTypeSmall_t >( tag[0] & 0xFFFF );
+        *numBytes = static_cast< mNumBytesSmall_t >( tag[0] >> 16 );
+        ifs.seekg( pos + static_cast< std::streamoff >( sizeof(mDataType_t) ) );
     }
     if( *dataType > matlab::DataTypes::miUTF32 )
     {
@@ -162,197 +282,439 @@ bool matlab::MatReader::readTagField( mDataType_t* const dataType, mNumBytes_t*
     return true;
 }
 
-bool matlab::MatReader::readArraySubelements( ElementInfo* const element, std::ifstream& ifs )
+bool matlab::MatReader::readMatricesDouble( std::vector< Eigen::MatrixXd >* const matrices,
+                const std::vector< std::string >& names, const std::list< ElementInfo >& elements,
+                const std::string& fileName, const FileInfo& info, ThreadPool* const pool )
 {
-    if( element == NULL )
+    if( matrices == NULL )
     {
-        log::error( CLASS ) << "ElementInfo_t is null!";
+        log::error( CLASS ) << "Matrix vector is null!";
         return false;
     }
+    if( pool == NULL )
+    {
+        ThreadPool tmpPool;
+        return readMatricesDouble( matrices, names, elements, fileName, info, &tmpPool );
+    }
 
-    ifs.seekg( element->pos );
-    ifs.seekg( 8, ifstream::cur );
-    if( !ifs.good() )
+    typedef std::unordered_map< std::string, const ElementInfo* > ElementMapT;
+    ElementMapT elementsByName;
+    for( std::list< ElementInfo >::const_iterator it = elements.begin(); it != elements.end(); ++it )
     {
-        log::error( CLASS ) << "Could not jump to element: " << element->pos;
-        ifs.seekg( element->pos );
-        return false;
+        elementsByName.insert( std::make_pair( it->arrayName, &( *it ) ) );
     }
 
-    matlab::mDataType_t type;
-    matlab::mNumBytes_t bytes;
-    std::streampos tagStart;
-    // Read Array Flags //
-    // ---------------- //
-    if( !readTagField( &type, &bytes, ifs ) )
+    std::vector< const ElementInfo* > toRead( names.size(), NULL );
+    bool success = true;
+    for( size_t i = 0; i < names.size(); ++i )
     {
-        log::error( CLASS ) << "Could not read Array Flags!";
-        return false;
+        const ElementMapT::const_iterator it = elementsByName.find( names[i] );
+        if( it == elementsByName.end() )
+        {
+            log::error( CLASS ) << "Element not found: " << names[i];
+            success = false;
+            continue;
+        }
+        toRead[i] = it->second;
     }
-    else
-        if( bytes != 8 || type != DataTypes::miUINT32 )
+
+    matrices->clear();
+    matrices->resize( names.size() );
+
+    // Each thread opens the file once and fetches the next element, when it has finished its previous element.
+    std::atomic< size_t > next( 0 );
+    std::atomic< bool > allRead( true );
+    const std::function< void( size_t ) > worker = [&]( size_t )
+    {
+        std::ifstream ifs;
+        for( size_t i = next++; i < toRead.size(); i = next++ )
         {
-            log::error( CLASS ) << "Bytes for Array Flags or Data Type is wrong: " << bytes << " (expected: 8) or "
-                            << type << " (expected: " << DataTypes::miUINT32 << ")";
-            ifs.seekg( element->pos );
-            return false;
+            if( toRead[i] == NULL )
+            {
+                continue;
+            }
+            if( !ifs.is_open() )
+            {
+                ifs.open( fileName.c_str(), std::ifstream::in | std::ifstream::binary );
+                if( !ifs.is_open() )
+                {
+                    log::error( CLASS ) << "Could not open file: " << fileName;
+                    allRead = false;
+                    return;
+                }
+            }
+            if( !readMatrixDouble( &( *matrices )[i], *toRead[i], ifs, info ) )
+            {
+                allRead = false;
+            }
         }
+    };
+    pool->parallelFor( std::min( pool->getThreadCount(), toRead.size() ), worker );
 
-    // Read flags and class
-    mArrayFlags_t arrayFlags[2];
-    ifs.read( ( char* )&arrayFlags, 8 );
-    const mArrayFlags_t arrayFlag = arrayFlags[0];
-    log::debug( CLASS ) << "Array Flag: " << arrayFlag;
-    if( ArrayFlags::isComplex( arrayFlag ) )
+    return success && allRead;
+}
+
+bool matlab::MatReader::readCompressedSubelements( ElementInfo* const element, DataSource* const source,
+                bool swapBytes )
+{
+    Inflater inflater( source, element->numBytes );
+
+    mDataType_t tag[2];
+    // Read Array Tag //
+    // -------------- //
+    if( !readTag( tag, &inflater, swapBytes ) || tag[0] != DataTypes::miMATRIX )
+    {
+        log::error( CLASS ) << "Compressed data is not a matrix!";
+        return false;
+    }
+
+    size_t numBytes;
+    if( !readSubelements( element, &inflater, swapBytes, &numBytes ) )
     {
-        log::debug( CLASS ) << "Is complex.";
+        return false;
     }
-    if( ArrayFlags::isGlobal( arrayFlag ) )
+
+    // Set Data Position
+    element->posData = inflater.getTotalOut();
+    return true;
+}
+
+bool matlab::MatReader::readSubelements( ElementInfo* const element, DataSource* const source, bool swapBytes,
+                size_t* const numBytes )
+{
+    mDataType_t tag[2];
+    *numBytes = 0;
+
+    // Read Array Flags //
+    // ---------------- //
+    mArrayFlags_t arrayFlags[2];
+    if( !readTag( tag, source, swapBytes ) || tag[0] != DataTypes::miUINT32 || tag[1] != 8
+                    || !source->read( arrayFlags, 8 ) )
     {
-        log::debug( CLASS ) << "Is global.";
+        log::error( CLASS ) << "Could not read Array Flags!";
+        return false;
     }
-    if( ArrayFlags::isLogical( arrayFlag ) )
+    if( swapBytes )
     {
-        log::debug( CLASS ) << "Is logical.";
+        ByteOrder::swap( arrayFlags, 2, sizeof(mArrayFlags_t) );
     }
+    *numBytes += 16;
+    element->arrayFlags = arrayFlags[0];
+    log::debug( CLASS ) << "Array Flag: " << element->arrayFlags;
 
-    element->arrayFlags = arrayFlag;
-    const mArrayType_t clazz = ArrayFlags::getArrayType( arrayFlag );
-    log::debug( CLASS ) << "Array Type/Class: " << ( miUINT32_t )ArrayFlags::getArrayType( arrayFlag );
-    if( !ArrayTypes::isNumericArray( clazz ) && clazz != ArrayTypes::mxCHAR_CLASS )
+    const mArrayType_t clazz = ArrayFlags::getArrayType( element->arrayFlags );
+    element->nzmax = clazz == ArrayTypes::mxSPARSE_CLASS ? arrayFlags[1] : 0;
+    if( !ArrayTypes::isNumericArray( clazz ) && clazz != ArrayTypes::mxCHAR_CLASS
+                    && clazz != ArrayTypes::mxSPARSE_CLASS )
     {
-        element->posData = ifs.tellg();
-        ifs.seekg( element->pos );
         return true;
     }
 
-    log::debug( CLASS ) << "Data element is numeric array. Retrieving more subelements.";
-
     // Read Dimension //
     // -------------- //
-    tagStart = ifs.tellg();
-    if( !readTagField( &type, &bytes, ifs ) )
+    if( !readTag( tag, source, swapBytes ) || tag[0] != DataTypes::miINT32 || tag[1] < 8
+                    || tag[1] % sizeof(miINT32_t) )
     {
         log::error( CLASS ) << "Could not read Dimension!";
         return false;
     }
-    else
-        if( bytes < 8 || type != DataTypes::miINT32 )
-        {
-            log::error( CLASS ) << "Bytes for Dimension or Data Type is wrong: " << bytes << " (expected: 8) or "
-                            << type << " (expected: " << DataTypes::miINT32 << ")";
-            ifs.seekg( element->pos );
-            return false;
-        }
-
-    // TODO(cpieloth): Check for dimensions n > 2
-    if( bytes != 8 )
+    std::vector< miINT32_t > dims( tag[1] / sizeof(miINT32_t) );
+    const size_t padding = tag[1] % 8 ? 8 - ( tag[1] % 8 ) : 0;
+    if( !source->read( dims.data(), tag[1] ) || ( padding && !source->skip( padding ) ) )
     {
-        log::error( CLASS ) << "Dimension n != 2 is not yet supported!";
+        log::error( CLASS ) << "Could not read Dimension!";
         return false;
     }
-    ifs.read( ( char* )&element->rows, sizeof(miINT32_t) );
-    ifs.read( ( char* )&element->cols, sizeof(miINT32_t) );
-
-    if( element->rows < 1 || element->cols < 1 )
+    *numBytes += 8 + tag[1] + padding;
+    if( swapBytes )
+    {
+        ByteOrder::swap( dims.data(), dims.size(), sizeof(miINT32_t) );
+    }
+    if( !setDimensions( element, dims ) )
     {
-        log::error( CLASS ) << "Rows/Cols error: " << element->rows << "x" << element->cols;
-        ifs.seekg( element->pos );
         return false;
     }
-    log::debug( CLASS ) << "Array size: " << element->rows << "x" << element->cols;
-    nextElement( ifs, tagStart, bytes );
 
     // Read Array Name //
     // --------------- //
-    tagStart = ifs.tellg();
-    if( !readTagField( &type, &bytes, ifs ) )
+    if( !source->read( tag, 8 ) )
     {
         log::error( CLASS ) << "Could not read Array Name!";
         return false;
     }
+    *numBytes += 8;
+    if( swapBytes )
+    {
+        ByteOrder::swap( &tag[0], 1, sizeof(mDataType_t) );
+    }
+    char name[8];
+    if( tag[0] > DataTypes::miUTF32 )
+    {
+        // Small Data Element Format, name is stored in the tag.
+        const mDataTypeSmall_t typeSmall = tag[0] & 0xFFFF;
+        const mNumBytesSmall_t bytesSmall = tag[0] >> 16;
+        if( typeSmall != DataTypes::miINT8 || bytesSmall > 4 )
+        {
+            log::error( CLASS ) << "Data Type is wrong: " << typeSmall << " (expected: " << DataTypes::miINT8 << ")";
+            return false;
+        }
+        memcpy( name, &tag[1], bytesSmall );
+        element->arrayName.assign( name, bytesSmall );
+    }
     else
-        if( type != DataTypes::miINT8 )
+    {
+        if( swapBytes )
+        {
+            ByteOrder::swap( &tag[1], 1, sizeof(mNumBytes_t) );
+        }
+        if( tag[0] != DataTypes::miINT8 )
         {
-            log::error( CLASS ) << "Data Type is wrong: " << type << " (expected: " << DataTypes::miINT8 << ")";
-            ifs.seekg( element->pos );
+            log::error( CLASS ) << "Data Type is wrong: " << tag[0] << " (expected: " << DataTypes::miINT8 << ")";
             return false;
         }
-
-    char* tmp = ( char* )malloc( bytes + 1 );
-    ifs.read( tmp, bytes );
-    tmp[bytes] = '\0';
-    element->arrayName.assign( tmp );
-    free( tmp );
+        element->arrayName.clear();
+        for( size_t i = 0; i < tag[1]; i += 8 )
+        {
+            if( !source->read( name, 8 ) )
+            {
+                log::error( CLASS ) << "Could not read Array Name!";
+                return false;
+            }
+            *numBytes += 8;
+            element->arrayName.append( name, std::min< size_t >( 8, tag[1] - i ) );
+        }
+    }
     log::debug( CLASS ) << "Array Name: " << element->arrayName;
-    if( bytes > 4 ) // Fix names with more than 4 characters, thx Patrick.
+    return true;
+}
+
+template< typename T >
+bool matlab::MatReader::readData( T* const data, size_t size, const ElementInfo& element, std::ifstream& ifs,
+                const FileInfo& info )
+{
+    // Check some errors //
+    // ----------------- //
+    if( data == NULL && size > 0 )
     {
-        tagStart += bytes;
+        log::error( CLASS ) << "Data is null!";
+        return false;
     }
-    nextElement( ifs, tagStart, bytes );
 
-    // Set Data Position
-    element->posData = ifs.tellg();
+    if( !checkNumericArray( element, info ) )
+    {
+        return false;
+    }
+
+    const std::streampos pos = ifs.tellg();
+    const bool swapBytes = ByteOrder::isSwapped( info );
+
+    // Read data //
+    // --------- //
+    bool success;
+    if( element.dataType == DataTypes::miCOMPRESSED )
+    {
+        // Inflate directly into the destination.
+        ifs.seekg( element.pos + static_cast< std::streamoff >( 8 ) );
+        Inflater inflater( ifs, element.numBytes );
+        success = inflater.skip( element.posData ) && readNumericData( data, size, &inflater, swapBytes );
+    }
+    else
+    {
+        ifs.seekg( element.posData );
+        StreamSource source( ifs );
+        success = readNumericData( data, size, &source, swapBytes );
+    }
+
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read array data!";
+        ifs.clear();
+        ifs.seekg( pos );
+        return false;
+    }
     return true;
 }
 
-bool matlab::MatReader::readMatrixDouble( Eigen::MatrixXd* const matrix, const ElementInfo& element, std::ifstream& ifs,
-                const FileInfo& info )
+template bool matlab::MatReader::readData< double >( double* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< float >( float* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< int8_t >( int8_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< uint8_t >( uint8_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< int16_t >( int16_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< uint16_t >( uint16_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< int32_t >( int32_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< uint32_t >( uint32_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< int64_t >( int64_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+template bool matlab::MatReader::readData< uint64_t >( uint64_t* const, size_t, const ElementInfo&, std::ifstream&,
+                const FileInfo& );
+
+template< typename T >
+bool matlab::MatReader::readBlockData( T* const data, size_t startRow, size_t startCol, size_t blockRows,
+                size_t blockCols, const ElementInfo& element, std::ifstream& ifs, const FileInfo& info )
 {
     // Check some errors //
     // ----------------- //
-    if( matrix == NULL )
+    if( data == NULL && blockRows * blockCols > 0 )
     {
-        log::error( CLASS ) << "Matrix object is null!";
+        log::error( CLASS ) << "Data is null!";
+        return false;
+    }
+    if( !checkNumericArray( element, info ) )
+    {
+        return false;
+    }
+
+    const std::streampos pos = ifs.tellg();
+    const bool swapBytes = ByteOrder::isSwapped( info );
+
+    // Read block //
+    // ---------- //
+    bool success;
+    if( element.dataType == DataTypes::miCOMPRESSED )
+    {
+        // Compressed data can not be seeked, the data in front of the block is inflated and discarded.
+        ifs.seekg( element.pos + static_cast< std::streamoff >( 8 ) );
+        Inflater inflater( ifs, element.numBytes );
+        success = inflater.skip( element.posData )
+                        && readNumericBlock( data, element.rows, element.cols, startRow, startCol, blockRows,
+                                        blockCols, &inflater, swapBytes );
+    }
+    else
+    {
+        ifs.seekg( element.posData );
+        StreamSource source( ifs );
+        success = readNumericBlock( data, element.rows, element.cols, startRow, startCol, blockRows, blockCols,
+                        &source, swapBytes );
+    }
+
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read block!";
+        ifs.clear();
+        ifs.seekg( pos );
         return false;
     }
+    return true;
+}
 
-    if( info.fileSize <= static_cast< size_t >( element.posData ) )
+template bool matlab::MatReader::readBlockData< double >( double* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< float >( float* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< int8_t >( int8_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< uint8_t >( uint8_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< int16_t >( int16_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< uint16_t >( uint16_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< int32_t >( int32_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< uint32_t >( uint32_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< int64_t >( int64_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+template bool matlab::MatReader::readBlockData< uint64_t >( uint64_t* const, size_t, size_t, size_t, size_t,
+                const ElementInfo&, std::ifstream&, const FileInfo& );
+
+bool matlab::MatReader::checkNumericArray( const ElementInfo& element, const FileInfo& info )
+{
+    const bool isCompressed = element.dataType == DataTypes::miCOMPRESSED;
+    if( !isCompressed && info.fileSize <= static_cast< size_t >( element.posData ) )
     {
         log::error( CLASS ) << "Data position is beyond file end!";
         return false;
     }
 
-    if( element.dataType != DataTypes::miMATRIX )
+    if( element.dataType != DataTypes::miMATRIX && !isCompressed )
     {
         log::error( CLASS ) << "Data type is not a matrix: " << element.dataType;
         return false;
     }
 
     const mArrayType_t arrayType = ArrayFlags::getArrayType( element.arrayFlags );
-    if( arrayType != ArrayTypes::mxDOUBLE_CLASS )
+    if( !ArrayTypes::isNumericArray( arrayType ) )
     {
-        log::error( CLASS ) << "Numeric Types does not match!";
+        log::error( CLASS ) << "Array type is not numeric: " << ( int )arrayType;
         return false;
     }
+    return true;
+}
 
-    const std::streampos pos = ifs.tellg();
-
-    // Read data //
-    // --------- //
-    ifs.seekg( element.posData );
-    mDataType_t type;
-    mNumBytes_t bytes;
-    if( !readTagField( &type, &bytes, ifs ) )
+bool matlab::MatReader::setDimensions( ElementInfo* const element, const std::vector< miINT32_t >& dims )
+{
+    if( dims.size() < 2 )
     {
-        log::error( CLASS ) << "Could not read Data Element!";
-        ifs.seekg( pos );
+        log::error( CLASS ) << "Array has less than 2 dimensions!";
         return false;
     }
-    if( type != DataTypes::miDOUBLE )
+
+    // All dimensions but the first are combined to the columns.
+    int64_t cols = 1;
+    for( size_t i = 0; i < dims.size(); ++i )
     {
-        log::error( CLASS ) << "Numeric Types does not match or compressed data, which is not supported: " << type;
-        ifs.seekg( pos );
-        return false;
+        if( dims[i] < 1 )
+        {
+            log::error( CLASS ) << "Dimension error: " << dims[i] << " at " << i;
+            return false;
+        }
+        if( i > 0 )
+        {
+            cols *= dims[i];
+        }
+        if( cols > std::numeric_limits< miINT32_t >::max() )
+        {
+            log::error( CLASS ) << "Array has too many elements!";
+            return false;
+        }
     }
 
-    matrix->resize( element.rows, element.cols );
-    ifs.read( ( char* )matrix->data(), bytes );
+    element->dims = dims;
+    element->rows = dims[0];
+    element->cols = cols;
+    log::debug( CLASS ) << "Array size: " << element->rows << "x" << element->cols << ", dimensions: " << dims.size();
+    return true;
+}
 
-    nextElement( ifs, element.posData, bytes );
+bool matlab::MatReader::getTensorDimensions( Eigen::Index* const dims, int rank, const ElementInfo& element )
+{
+    if( element.dims.empty() )
+    {
+        log::error( CLASS ) << "Element has no dimensions!";
+        return false;
+    }
+    for( int i = 0; i < rank; ++i )
+    {
+        dims[i] = static_cast< size_t >( i ) < element.dims.size() ? element.dims[i] : 1;
+    }
+    // Remaining dimensions must be singleton, if the array has more dimensions than the tensor.
+    for( size_t i = rank; i < element.dims.size(); ++i )
+    {
+        if( element.dims[i] != 1 )
+        {
+            log::error( CLASS ) << "Array has more dimensions than the tensor: " << element.dims.size() << " > "
+                            << rank;
+            return false;
+        }
+    }
     return true;
 }
 
+bool matlab::MatReader::readMatrixDouble( Eigen::MatrixXd* const matrix, const ElementInfo& element, std::ifstream& ifs,
+                const FileInfo& info )
+{
+    return readMatrix( matrix, element, ifs, info );
+}
+
 bool matlab::MatReader::readMatrixComplex( Eigen::MatrixXcd* const matrix, const ElementInfo& element,
                 std::ifstream& ifs, const FileInfo& info )
 {
@@ -364,70 +726,128 @@ bool matlab::MatReader::readMatrixComplex( Eigen::MatrixXcd* const matrix, const
         return false;
     }
 
-    if( info.fileSize <= static_cast< size_t >( element.posData ) )
+    const bool isCompressed = element.dataType == DataTypes::miCOMPRESSED;
+    if( !isCompressed && info.fileSize <= static_cast< size_t >( element.posData ) )
     {
         log::error( CLASS ) << "Data position is beyond file end!";
         return false;
     }
 
-    if( element.dataType != DataTypes::miMATRIX )
+    if( element.dataType != DataTypes::miMATRIX && !isCompressed )
     {
         log::error( CLASS ) << "Data type is not a matrix: " << element.dataType;
         return false;
     }
 
-    const bool isDouble = ArrayFlags::getArrayType( element.arrayFlags ) == ArrayTypes::mxDOUBLE_CLASS;
+    const bool isNumeric = ArrayTypes::isNumericArray( ArrayFlags::getArrayType( element.arrayFlags ) );
     const bool isComplex = ArrayFlags::isComplex( element.arrayFlags );
-    if( !isDouble || !isComplex )
+    if( !isNumeric || !isComplex )
     {
         log::error( CLASS ) << "Numeric Types does not match!";
         return false;
     }
 
     const std::streampos pos = ifs.tellg();
+    const bool swapBytes = ByteOrder::isSwapped( info );
 
     // Read data //
     // --------- //
-    ifs.seekg( element.posData );
-    mDataType_t type;
-    mNumBytes_t bytes;
-    if( !readTagField( &type, &bytes, ifs ) )
+    // Real and imaginary part are read directly into the interleaved storage of the complex matrix.
+    matrix->resize( element.rows, element.cols );
+    double* const real = reinterpret_cast< double* >( matrix->data() );
+    double* const imag = real + 1;
+    bool success;
+    if( isCompressed )
     {
-        log::error( CLASS ) << "Could not read real data tag!";
+        ifs.seekg( element.pos + static_cast< std::streamoff >( 8 ) );
+        Inflater inflater( ifs, element.numBytes );
+        success = inflater.skip( element.posData )
+                        && readNumericDataInterleaved( real, matrix->size(), &inflater, swapBytes )
+                        && readNumericDataInterleaved( imag, matrix->size(), &inflater, swapBytes );
+    }
+    else
+    {
+        ifs.seekg( element.posData );
+        StreamSource source( ifs );
+        success = readNumericDataInterleaved( real, matrix->size(), &source, swapBytes )
+                        && readNumericDataInterleaved( imag, matrix->size(), &source, swapBytes );
+    }
+
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read real or imag data!";
+        ifs.clear();
         ifs.seekg( pos );
         return false;
     }
-    if( type != DataTypes::miDOUBLE )
+    return true;
+}
+
+bool matlab::MatReader::readMatrixSparse( Eigen::SparseMatrix< double >* const matrix, const ElementInfo& element,
+                std::ifstream& ifs, const FileInfo& info )
+{
+    // Check some errors //
+    // ----------------- //
+    if( matrix == NULL )
     {
-        log::error( CLASS ) << "Numeric Type does not match or compressed data, which is not supported: " << type;
-        ifs.seekg( pos );
+        log::error( CLASS ) << "Matrix object is null!";
         return false;
     }
 
-    Eigen::MatrixXd real( element.rows, element.cols );
-    ifs.read( ( char* )real.data(), bytes );
+    const bool isCompressed = element.dataType == DataTypes::miCOMPRESSED;
+    if( !isCompressed && info.fileSize <= static_cast< size_t >( element.posData ) )
+    {
+        log::error( CLASS ) << "Data position is beyond file end!";
+        return false;
+    }
 
-    if( !readTagField( &type, &bytes, ifs ) )
+    if( element.dataType != DataTypes::miMATRIX && !isCompressed )
     {
-        log::error( CLASS ) << "Could not read imag data tag!";
-        ifs.seekg( pos );
+        log::error( CLASS ) << "Data type is not a matrix: " << element.dataType;
         return false;
     }
-    if( type != DataTypes::miDOUBLE )
+
+    if( ArrayFlags::getArrayType( element.arrayFlags ) != ArrayTypes::mxSPARSE_CLASS )
     {
-        log::error( CLASS ) << "Numeric Type does not match or compressed data, which is not supported: " << type;
-        ifs.seekg( pos );
+        log::error( CLASS ) << "Array type is not sparse!";
+        return false;
+    }
+    if( ArrayFlags::isComplex( element.arrayFlags ) )
+    {
+        log::error( CLASS ) << "Complex sparse matrices are not yet supported!";
         return false;
     }
 
-    Eigen::MatrixXd imag( element.rows, element.cols );
-    ifs.read( ( char* )imag.data(), bytes );
+    const std::streampos pos = ifs.tellg();
+    const bool swapBytes = ByteOrder::isSwapped( info );
 
+    // Read data //
+    // --------- //
+    const size_t nzmax = std::max< size_t >( element.nzmax, 1 );
     matrix->resize( element.rows, element.cols );
-    matrix->real() = real;
-    matrix->imag() = imag;
+    matrix->resizeNonZeros( nzmax );
+    bool success;
+    if( isCompressed )
+    {
+        ifs.seekg( element.pos + static_cast< std::streamoff >( 8 ) );
+        Inflater inflater( ifs, element.numBytes );
+        success = inflater.skip( element.posData ) && readSparseData( matrix, nzmax, &inflater, swapBytes );
+    }
+    else
+    {
+        ifs.seekg( element.posData );
+        StreamSource source( ifs );
+        success = readSparseData( matrix, nzmax, &source, swapBytes );
+    }
 
-    nextElement( ifs, element.posData, bytes );
+    if( !success )
+    {
+        log::error( CLASS ) << "Could not read sparse data!";
+        matrix->resize( 0, 0 );
+        ifs.clear();
+        ifs.seekg( pos );
+        return false;
+    }
     return true;
 }
 
@@ -439,7 +859,7 @@ void matlab::MatReader::nextElement( std::ifstream& ifs, const std::streampos& t
         ifs.seekg( 8, ifstream::cur );
         if( numBytes % 8 )
         {
-            numBytes = 8 - ( numBytes % 8 );
+            numBytes += 8 - ( numBytes % 8 );
         }
         ifs.seekg( numBytes, ifstream::cur );
     }
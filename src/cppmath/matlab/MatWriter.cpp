@@ -1,7 +1,11 @@
 #include <algorithm>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "../Logger.hpp"
+#include "Compression.hpp"
 #include "io.hpp"
 
 using std::ofstream;
@@ -11,6 +15,41 @@ using namespace cppmath;
 
 const std::string matlab::MatWriter::CLASS = "MatWriter";
 
+namespace
+{
+    /**
+     * Number of values, which are de-interleaved at once.
+     */
+    const size_t CHUNK_SIZE = 4096;
+
+    /**
+     * Writes every second value, i.e. data[2 * i], e.g. the real or imaginary part of complex values.
+     */
+    void writeDeinterleaved( std::ostream& os, const double* const data, size_t size )
+    {
+        double buffer[CHUNK_SIZE];
+        for( size_t i = 0; i < size; i += CHUNK_SIZE )
+        {
+            const size_t n = std::min( CHUNK_SIZE, size - i );
+            // Constant stride, so the compiler vectorizes the de-interleaving.
+            const double* const src = data + 2 * i;
+            for( size_t j = 0; j < n; ++j )
+            {
+                buffer[j] = src[2 * j];
+            }
+            os.write( ( const char* )buffer, n * sizeof(double) );
+        }
+    }
+
+    /**
+     * Returns the size of a data element with the given number of bytes, including tag and padding.
+     */
+    size_t getElementBytes( size_t numBytes )
+    {
+        return 8 + numBytes + ( numBytes % 8 ? 8 - numBytes % 8 : 0 );
+    }
+}
+
 bool matlab::MatWriter::writeHeader( ofstream& ofs, const std::string& description )
 {
     if( !ofs || ofs.bad() )
@@ -46,20 +85,101 @@ bool matlab::MatWriter::writeHeader( ofstream& ofs, const std::string& descripti
     return true;
 }
 
-size_t matlab::MatWriter::writeTagField( std::ofstream& ofs, const mDataType_t& dataType, const mNumBytes_t numBytes )
+size_t matlab::MatWriter::writeTagField( std::ostream& os, const mDataType_t& dataType, const mNumBytes_t numBytes )
 {
-    if( !ofs || ofs.bad() )
+    if( !os || os.bad() )
     {
         log::error( CLASS ) << "Problem with output stream!!";
         return 0;
     }
 
-    ofs.write( ( char* )&dataType, sizeof( dataType ) );
-    ofs.write( ( char* )&numBytes, sizeof( numBytes ) );
+    os.write( ( char* )&dataType, sizeof( dataType ) );
+    os.write( ( char* )&numBytes, sizeof( numBytes ) );
 
     return sizeof( dataType ) + sizeof( numBytes );
 }
 
+size_t matlab::MatWriter::writePadding( std::ostream& os, size_t numBytes )
+{
+    size_t writtenBytes = 0;
+    if( numBytes % 8 )
+    {
+        numBytes = 8 - ( numBytes % 8 );
+        for( size_t i = 0; i < numBytes; ++i )
+        {
+            os.put( '\0' );
+            ++writtenBytes;
+        }
+    }
+    return writtenBytes;
+}
+
+size_t matlab::MatWriter::writeArraySubelements( std::ostream& os, const mArrayFlags_t& arrayFlags,
+                const miINT32_t rows, const miINT32_t cols, const std::string& arrayName, const miUINT32_t nzmax )
+{
+    std::vector< miINT32_t > dims( 2 );
+    dims[0] = rows;
+    dims[1] = cols;
+    return writeArraySubelements( os, arrayFlags, dims, arrayName, nzmax );
+}
+
+size_t matlab::MatWriter::writeArraySubelements( std::ostream& os, const mArrayFlags_t& arrayFlags,
+                const std::vector< miINT32_t >& dims, const std::string& arrayName, const miUINT32_t nzmax )
+{
+    mDataType_t type;
+    mNumBytes_t bytes;
+    size_t tmpBytes = 0;
+    size_t writtenBytes = 0;
+
+    // Write Array Flags //
+    // ----------------- //
+    type = DataTypes::miUINT32;
+    bytes = 8;
+    tmpBytes = writeTagField( os, type, bytes );
+    writtenBytes += tmpBytes;
+    if( tmpBytes == 0 )
+    {
+        log::error( CLASS ) << "Could not write tag for Array Flags!";
+        return 0;
+    }
+
+    os.write( ( char* )&arrayFlags, sizeof( arrayFlags ) );
+    os.write( ( char* )&nzmax, sizeof( nzmax ) );
+    writtenBytes += sizeof( arrayFlags ) + sizeof( nzmax );
+
+    // Write Dimension //
+    // --------------- //
+    type = DataTypes::miINT32;
+    bytes = dims.size() * sizeof(miINT32_t);
+    tmpBytes = writeTagField( os, type, bytes );
+    writtenBytes += tmpBytes;
+    if( tmpBytes == 0 )
+    {
+        log::error( CLASS ) << "Could not write tag for Dimension!";
+        return 0;
+    }
+    os.write( ( const char* )dims.data(), bytes );
+    writtenBytes += bytes;
+    writtenBytes += writePadding( os, bytes );
+
+    // Write Array Name //
+    // ---------------- //
+    type = DataTypes::miINT8;
+    bytes = arrayName.length();
+    tmpBytes = writeTagField( os, type, bytes );
+    writtenBytes += tmpBytes;
+    if( tmpBytes == 0 )
+    {
+        log::error( CLASS ) << "Could not write tag for Array Name!";
+        return 0;
+    }
+    os.write( arrayName.c_str(), bytes );
+    writtenBytes += bytes;
+    writtenBytes += writePadding( os, bytes );
+
+    return writtenBytes;
+}
+
 size_t matlab::MatWriter::writeMatrixDouble( std::ofstream& ofs, const Eigen::MatrixXd& matrix,
                 const std::string& arrayName )
 {
@@ -89,99 +209,283 @@ size_t matlab::MatWriter::writeMatrixDouble( std::ofstream& ofs, const Eigen::Ma
         log::error( CLASS ) << "Could not write Array Tag!";
         return writtenBytes;
     }
-    // Write Array Flags //
+
+    // Write Array Flags, Dimension and Name //
+    // ------------------------------------- //
+    tmpBytes = writeArraySubelements( ofs, ArrayTypes::mxDOUBLE_CLASS, matrix.rows(), matrix.cols(), arrayName );
+    writtenBytes += tmpBytes;
+    if( tmpBytes == 0 )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Could not write Array Subelements!";
+        return writtenBytes;
+    }
+
+    // Write matrix data //
     // ----------------- //
-    type = DataTypes::miUINT32;
-    bytes = 8;
+    type = DataTypes::miDOUBLE;
+    bytes = matrix.rows() * matrix.cols() * sizeof(miDouble_t);
     tmpBytes = writeTagField( ofs, type, bytes );
     writtenBytes += tmpBytes;
     if( tmpBytes == 0 )
     {
         ofs.seekp( pos );
-        log::error( CLASS ) << "Could not write tag for Array Flags!";
+        log::error( CLASS ) << "Could not write tag for Matrix!";
         return writtenBytes;
     }
 
-    mArrayFlags_t arrayFlags = 0;
-    // arrayFlags |= ArrayFlags::MASK_GLOBAL;
-    mArrayType_t arrayType = ArrayTypes::mxDOUBLE_CLASS;
-    mArrayFlags_t arrayTypeCast = arrayType;
-    arrayFlags |= arrayTypeCast; // TODO(pieloth): Check if this is correct
-    ofs.write( ( char* )&arrayFlags, sizeof( arrayFlags ) );
-    writtenBytes += sizeof( arrayFlags );
-    arrayType = 0;
-    ofs.write( ( char* )&arrayFlags, sizeof( arrayFlags ) );
-    writtenBytes += sizeof( arrayFlags );
+    ofs.write( ( char* )matrix.data(), bytes );
+    writtenBytes += bytes;
+    writtenBytes += writePadding( ofs, bytes );
 
-    // Write Dimension //
+    // Set correct numBytes for miMatrix //
+    // --------------------------------- //
+    bytes = writtenBytes - sizeof(mDataType_t) - sizeof(mNumBytes_t);
+    ofs.seekp( pos );
+    ofs.seekp( sizeof(mDataType_t), ofstream::cur );
+    ofs.write( ( char* )&bytes, sizeof(mNumBytes_t) );
+    ofs.seekp( bytes, ofstream::cur );
+
+    return writtenBytes;
+}
+
+size_t matlab::MatWriter::writeMatrixComplex( std::ofstream& ofs, const Eigen::MatrixXcd& matrix,
+                const std::string& arrayName )
+{
+    if( !ofs || ofs.bad() )
+    {
+        log::error( CLASS ) << "Problem with output stream!!";
+        return 0;
+    }
+
+    // Init //
+    // ---- //
+    const std::streampos pos = ofs.tellp();
+    size_t tmpBytes = 0;
+    size_t writtenBytes = 0;
+
+    // Write Array Tag //
     // --------------- //
-    type = DataTypes::miINT32;
-    bytes = 8;
-    tmpBytes = writeTagField( ofs, type, bytes );
+    tmpBytes = writeTagField( ofs, DataTypes::miMATRIX, 0 ); // set it after written subelements an data!
     writtenBytes += tmpBytes;
     if( tmpBytes == 0 )
     {
         ofs.seekp( pos );
-        log::error( CLASS ) << "Could not write tag for Dimension!";
+        log::error( CLASS ) << "Could not write Array Tag!";
         return writtenBytes;
     }
-    const miINT32_t rows = matrix.rows();
-    const miINT32_t cols = matrix.cols();
-    ofs.write( ( char* )&rows, sizeof( rows ) );
-    ofs.write( ( char* )&cols, sizeof( cols ) );
-    writtenBytes += sizeof( rows ) + sizeof( cols );
 
-    // Write Array Name //
-    // ---------------- //
-    type = DataTypes::miINT8;
-    bytes = arrayName.length();
-    tmpBytes = writeTagField( ofs, type, bytes );
+    // Write Array Flags, Dimension and Name //
+    // ------------------------------------- //
+    const mArrayFlags_t arrayFlags = ArrayTypes::mxDOUBLE_CLASS | ArrayFlags::MASK_COMPLEX;
+    tmpBytes = writeArraySubelements( ofs, arrayFlags, matrix.rows(), matrix.cols(), arrayName );
     writtenBytes += tmpBytes;
     if( tmpBytes == 0 )
     {
         ofs.seekp( pos );
-        log::error( CLASS ) << "Could not write tag for Array Name!";
+        log::error( CLASS ) << "Could not write Array Subelements!";
         return writtenBytes;
     }
-    ofs.write( arrayName.c_str(), bytes );
+
+    // Write real and imaginary part, de-interleaved from the complex values //
+    // --------------------------------------------------------------------- //
+    const double* const real = reinterpret_cast< const double* >( matrix.data() );
+    const size_t bytes = matrix.size() * sizeof(miDouble_t);
+    if( writtenBytes - sizeof(mDataType_t) - sizeof(mNumBytes_t) + 2 * ( 8 + bytes )
+                    > std::numeric_limits< mNumBytes_t >::max() )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Matrix exceeds the maximum element size!";
+        return writtenBytes;
+    }
+    writtenBytes += writeTagField( ofs, DataTypes::miDOUBLE, bytes );
+    writeDeinterleaved( ofs, real, matrix.size() );
+    writtenBytes += bytes;
+    writtenBytes += writeTagField( ofs, DataTypes::miDOUBLE, bytes );
+    writeDeinterleaved( ofs, real + 1, matrix.size() );
     writtenBytes += bytes;
-    if( bytes % 8 )
+    if( !ofs.good() )
     {
-        bytes = 8 - ( bytes % 8 );
-        for( size_t i = 0; i < bytes; ++i )
-        {
-            ofs.put( '\0' );
-            ++writtenBytes;
-        }
+        ofs.clear();
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Could not write complex data!";
+        return writtenBytes;
     }
 
-    // Write matrix data //
-    // ----------------- //
-    type = DataTypes::miDOUBLE;
-    bytes = matrix.rows() * matrix.cols() * sizeof(miDouble_t);
-    tmpBytes = writeTagField( ofs, type, bytes );
+    // Set correct numBytes for miMatrix //
+    // --------------------------------- //
+    const mNumBytes_t numBytes = writtenBytes - sizeof(mDataType_t) - sizeof(mNumBytes_t);
+    ofs.seekp( pos );
+    ofs.seekp( sizeof(mDataType_t), ofstream::cur );
+    ofs.write( ( char* )&numBytes, sizeof(mNumBytes_t) );
+    ofs.seekp( numBytes, ofstream::cur );
+
+    return writtenBytes;
+}
+
+size_t matlab::MatWriter::writeMatrixSparse( std::ofstream& ofs, const Eigen::SparseMatrix< double >& matrix,
+                const std::string& arrayName )
+{
+    if( !matrix.isCompressed() )
+    {
+        Eigen::SparseMatrix< double > compressed( matrix );
+        compressed.makeCompressed();
+        return writeMatrixSparse( ofs, compressed, arrayName );
+    }
+    if( !ofs || ofs.bad() )
+    {
+        log::error( CLASS ) << "Problem with output stream!!";
+        return 0;
+    }
+
+    // Init //
+    // ---- //
+    const std::streampos pos = ofs.tellp();
+    const size_t nnz = matrix.nonZeros();
+    // MATLAB expects at least one element, even for an empty matrix.
+    const miUINT32_t nzmax = std::max< size_t >( nnz, 1 );
+    size_t tmpBytes = 0;
+    size_t writtenBytes = 0;
+
+    // Check the element size before writing anything //
+    // ---------------------------------------------- //
+    std::ostringstream subelements;
+    if( writeArraySubelements( subelements, ArrayTypes::mxSPARSE_CLASS, matrix.rows(), matrix.cols(), arrayName,
+                    nzmax ) == 0 )
+    {
+        log::error( CLASS ) << "Could not write Array Subelements!";
+        return 0;
+    }
+    const std::string subelementBytes = subelements.str();
+    const size_t irBytes = nnz * sizeof(miINT32_t);
+    const size_t jcBytes = ( matrix.cols() + 1 ) * sizeof(miINT32_t);
+    const size_t prBytes = nnz * sizeof(miDouble_t);
+    if( subelementBytes.size() + getElementBytes( irBytes ) + getElementBytes( jcBytes ) + getElementBytes( prBytes )
+                    > std::numeric_limits< mNumBytes_t >::max() )
+    {
+        log::error( CLASS ) << "Matrix exceeds the maximum element size!";
+        return 0;
+    }
+
+    // Write Array Tag //
+    // --------------- //
+    tmpBytes = writeTagField( ofs, DataTypes::miMATRIX, 0 ); // set it after written subelements an data!
     writtenBytes += tmpBytes;
     if( tmpBytes == 0 )
     {
         ofs.seekp( pos );
-        log::error( CLASS ) << "Could not write tag for Matrix!";
+        log::error( CLASS ) << "Could not write Array Tag!";
         return writtenBytes;
     }
 
-    ofs.write( ( char* )matrix.data(), bytes );
-    writtenBytes += bytes;
-    if( bytes % 8 )
+    // Write Array Flags, Dimension and Name //
+    // ------------------------------------- //
+    ofs.write( subelementBytes.data(), subelementBytes.size() );
+    writtenBytes += subelementBytes.size();
+
+    // Write row indices, column offsets and values //
+    // -------------------------------------------- //
+    tmpBytes = writeTagField( ofs, DataTypes::miINT32, irBytes );
+    ofs.write( ( const char* )matrix.innerIndexPtr(), irBytes );
+    tmpBytes += irBytes + writePadding( ofs, irBytes );
+    tmpBytes += writeTagField( ofs, DataTypes::miINT32, jcBytes );
+    ofs.write( ( const char* )matrix.outerIndexPtr(), jcBytes );
+    tmpBytes += jcBytes + writePadding( ofs, jcBytes );
+    tmpBytes += writeTagField( ofs, DataTypes::miDOUBLE, prBytes );
+    ofs.write( ( const char* )matrix.valuePtr(), prBytes );
+    tmpBytes += prBytes + writePadding( ofs, prBytes );
+    writtenBytes += tmpBytes;
+    if( !ofs.good() )
     {
-        bytes = 8 - ( bytes % 8 );
-        for( size_t i = 0; i < bytes; ++i )
-        {
-            ofs.put( '\0' );
-            ++writtenBytes;
-        }
+        ofs.clear();
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Could not write sparse data!";
+        return writtenBytes;
     }
 
     // Set correct numBytes for miMatrix //
     // --------------------------------- //
+    const mNumBytes_t bytes = writtenBytes - sizeof(mDataType_t) - sizeof(mNumBytes_t);
+    ofs.seekp( pos );
+    ofs.seekp( sizeof(mDataType_t), ofstream::cur );
+    ofs.write( ( char* )&bytes, sizeof(mNumBytes_t) );
+    ofs.seekp( bytes, ofstream::cur );
+
+    return writtenBytes;
+}
+
+size_t matlab::MatWriter::writeMatrixDoubleCompressed( std::ofstream& ofs, const Eigen::MatrixXd& matrix,
+                const std::string& arrayName, int level )
+{
+    if( !ofs || ofs.bad() )
+    {
+        log::error( CLASS ) << "Problem with output stream!!";
+        return 0;
+    }
+
+    // Init //
+    // ---- //
+    const std::streampos pos = ofs.tellp();
+    mNumBytes_t bytes;
+    size_t tmpBytes = 0;
+    size_t writtenBytes = 0;
+
+    // Write Compressed Tag //
+    // -------------------- //
+    bytes = 0; // set it after compression!
+    tmpBytes = writeTagField( ofs, DataTypes::miCOMPRESSED, bytes );
+    writtenBytes += tmpBytes;
+    if( tmpBytes == 0 )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Could not write Compressed Tag!";
+        return writtenBytes;
+    }
+
+    // Create uncompressed Array Tag, Subelements and Data Tag //
+    // ------------------------------------------------------- //
+    const size_t dataBytes = matrix.size() * sizeof(miDouble_t);
+    std::ostringstream header;
+    writeTagField( header, DataTypes::miMATRIX, 0 );
+    tmpBytes = writeArraySubelements( header, ArrayTypes::mxDOUBLE_CLASS, matrix.rows(), matrix.cols(), arrayName );
+    if( tmpBytes == 0 )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Could not write Array Subelements!";
+        return writtenBytes;
+    }
+    if( tmpBytes + 8 + dataBytes > std::numeric_limits< mNumBytes_t >::max() )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Matrix exceeds the maximum element size!";
+        return writtenBytes;
+    }
+    writeTagField( header, DataTypes::miDOUBLE, dataBytes );
+    std::string headerBytes = header.str();
+    bytes = headerBytes.size() - sizeof(mDataType_t) - sizeof(mNumBytes_t) + dataBytes;
+    headerBytes.replace( sizeof(mDataType_t), sizeof(mNumBytes_t), ( char* )&bytes, sizeof(mNumBytes_t) );
+
+    // Compress header and matrix data directly from the matrix //
+    // -------------------------------------------------------- //
+    Deflater deflater( ofs, level );
+    const bool success = deflater.write( headerBytes.data(), headerBytes.size() )
+                    && deflater.write( matrix.data(), dataBytes ) && deflater.finish();
+    writtenBytes += deflater.getTotalOut();
+    if( !success )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Could not write compressed Matrix!";
+        return writtenBytes;
+    }
+    if( writtenBytes - sizeof(mDataType_t) - sizeof(mNumBytes_t) > std::numeric_limits< mNumBytes_t >::max() )
+    {
+        ofs.seekp( pos );
+        log::error( CLASS ) << "Compressed matrix exceeds the maximum element size!";
+        return writtenBytes;
+    }
+
+    // Set correct numBytes for miCompressed, no padding for compressed data //
+    // --------------------------------------------------------------------- //
     bytes = writtenBytes - sizeof(mDataType_t) - sizeof(mNumBytes_t);
     ofs.seekp( pos );
     ofs.seekp( sizeof(mDataType_t), ofstream::cur );
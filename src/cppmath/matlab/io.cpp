@@ -1,7 +1,72 @@
+#include <cstring> // memcpy
+
 #include "io.hpp"
 
 using namespace cppmath;
 
+namespace
+{
+    inline uint16_t swapWord( uint16_t word )
+    {
+        return __builtin_bswap16( word );
+    }
+
+    inline uint32_t swapWord( uint32_t word )
+    {
+        return __builtin_bswap32( word );
+    }
+
+    inline uint64_t swapWord( uint64_t word )
+    {
+        return __builtin_bswap64( word );
+    }
+
+    /**
+     * Swaps count words of type U. memcpy avoids aliasing and alignment issues and is optimized away.
+     */
+    template< typename U >
+    void swapWords( char* const bytes, size_t count )
+    {
+        for( size_t i = 0; i < count; ++i )
+        {
+            U word;
+            memcpy( &word, bytes + i * sizeof(U), sizeof(U) );
+            word = swapWord( word );
+            memcpy( bytes + i * sizeof(U), &word, sizeof(U) );
+        }
+    }
+}
+
+bool matlab::ByteOrder::isLittleEndianHost()
+{
+    const uint16_t word = 1;
+    return *( const uint8_t* )&word == 1;
+}
+
+bool matlab::ByteOrder::isSwapped( const FileInfo& info )
+{
+    return info.isLittleEndian != isLittleEndianHost();
+}
+
+void matlab::ByteOrder::swap( void* const data, size_t count, size_t width )
+{
+    char* const bytes = static_cast< char* >( data );
+    switch( width )
+    {
+        case 2:
+            swapWords< uint16_t >( bytes, count );
+            break;
+        case 4:
+            swapWords< uint32_t >( bytes, count );
+            break;
+        case 8:
+            swapWords< uint64_t >( bytes, count );
+            break;
+        default:
+            break;
+    }
+}
+
 bool matlab::ArrayFlags::isComplex( const mArrayFlags_t& data )
 {
     return data & ArrayFlags::MASK_COMPLEX;
@@ -41,5 +106,9 @@ bool matlab::ArrayTypes::isNumericArray( const mArrayType_t& type )
     {
         return true;
     }
+    if( type == ArrayTypes::mxINT64_CLASS || type == ArrayTypes::mxUINT64_CLASS )
+    {
+        return true;
+    }
     return false;
 }
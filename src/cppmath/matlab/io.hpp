@@ -5,11 +5,18 @@
 #include <fstream>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+#include "../Logger.hpp"
 
 namespace cppmath
 {
+    class ThreadPool;
+
     /**
      * A low-level C++ API to read/write MAT-file format v5 from MATLAB.
      *
@@ -49,7 +56,6 @@ namespace cppmath
          */
         namespace DataTypes
         {
-            // NOTE: incomplete
             const mDataType_t miINT8 = 1;
             const mDataType_t miUINT8 = 2;
             const mDataType_t miINT16 = 3;
@@ -61,12 +67,14 @@ namespace cppmath
             const mDataType_t miINT64 = 12;
             const mDataType_t miUINT64 = 13;
             const mDataType_t miMATRIX = 14;
+            const mDataType_t miCOMPRESSED = 15;
+            const mDataType_t miUTF8 = 16;
+            const mDataType_t miUTF16 = 17;
             const mDataType_t miUTF32 = 18;
         }
 
         /**
-         * MATLAB Array Types (Classes) for Array Flags Subelement.\n
-         * NOTE: incomplete
+         * MATLAB Array Types (Classes) for Array Flags Subelement.
          */
         namespace ArrayTypes
         {
@@ -78,7 +86,11 @@ namespace cppmath
              */
             bool isNumericArray( const mArrayType_t& type );
 
+            const mArrayType_t mxCELL_CLASS = 1;
+            const mArrayType_t mxSTRUCT_CLASS = 2;
+            const mArrayType_t mxOBJECT_CLASS = 3;
             const mArrayType_t mxCHAR_CLASS = 4;
+            const mArrayType_t mxSPARSE_CLASS = 5;
             const mArrayType_t mxDOUBLE_CLASS = 6;
             const mArrayType_t mxSINGLE_CLASS = 7;
             const mArrayType_t mxINT8_CLASS = 8;
@@ -87,6 +99,8 @@ namespace cppmath
             const mArrayType_t mxUINT16_CLASS = 11;
             const mArrayType_t mxINT32_CLASS = 12;
             const mArrayType_t mxUINT32_CLASS = 13;
+            const mArrayType_t mxINT64_CLASS = 14;
+            const mArrayType_t mxUINT64_CLASS = 15;
         }
 
         /**
@@ -117,8 +131,37 @@ namespace cppmath
             size_t fileSize;
         } FileInfo;
 
+        /**
+         * Helper functions to handle the byte order of a MAT-file.
+         */
+        namespace ByteOrder
+        {
+            bool isLittleEndianHost();
+
+            /**
+             * Checks if the byte order of the file differs from the host, i.e. all values must be swapped.
+             *
+             * \param info File information.
+             * \return True if values must be swapped.
+             */
+            bool isSwapped( const FileInfo& info );
+
+            /**
+             * Reverses the bytes of each value in place. The loops are simple enough to be vectorized by the compiler.
+             *
+             * \param data Values to swap.
+             * \param count Number of values.
+             * \param width Size of a value in bytes, 1, 2, 4 or 8.
+             */
+            void swap( void* const data, size_t count, size_t width );
+        }
+
         /**
          * Information of a Data Element.
+         * For miCOMPRESSED elements, the array information is read from the compressed miMATRIX element
+         * and posData is the offset of the data in the uncompressed element.
+         * For arrays with n > 2 dimensions, cols is the product of all dimensions but the first,
+         * i.e. the array can be read as a 2-dim matrix in column-major order.
          */
         typedef struct ElementInfo
         {
@@ -129,12 +172,16 @@ namespace cppmath
             mArrayFlags_t arrayFlags;
             miINT32_t rows;
             miINT32_t cols;
+            std::vector< miINT32_t > dims; /**< All dimensions, at least 2. */
+            miUINT32_t nzmax; /**< Maximum number of non-zero elements, only for sparse arrays. */
             std::string arrayName;
         } ElementInfo;
 
+        class DataSource;
+
         /**
-         * Low-level reader for MAT-file format.
-         * \attention Does only supports: little endian, 2-dim double matrices, no compression.
+         * Low-level reader for MAT-file format. Files with a byte order different from the host are swapped on read.
+         * \attention Does only supports: numeric arrays and sparse matrices.
          */
         class MatReader
         {
@@ -152,6 +199,16 @@ namespace cppmath
              */
             static bool readHeader( FileInfo* const info, std::ifstream& ifs );
 
+            /**
+             * Parses the description, version and endian indicator of a MAT-file header.
+             * The file size is not changed.
+             *
+             * \param info Struct to store the information.
+             * \param header First 128 bytes of the file.
+             * \return true if successful, false otherwise.
+             */
+            static bool readHeader( FileInfo* const info, const char* const header );
+
             /**
              * Retrieves all data elements in the file. Leaves file position at the end of the header.
              *
@@ -163,6 +220,144 @@ namespace cppmath
             static bool retrieveDataElements( std::list< ElementInfo >* const elements, std::ifstream& ifs,
                             const FileInfo& info );
 
+            /**
+             * Reads the data element at the current file position and moves the position to the next element.
+             * Elements which could not be read, e.g. with unsupported subelements, are skipped.
+             *
+             * \param element Struct to store the information.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if an element was read, false on file end or on error.
+             */
+            static bool readDataElement( ElementInfo* const element, std::ifstream& ifs, const FileInfo& info );
+
+            /**
+             * Reads the numeric matrix which is contained by the element and converts it to the scalar type T,
+             * e.g. an int16 matrix into a Eigen::MatrixXd or a double matrix into a Eigen::MatrixXf.
+             * Available for T: double, float, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t,
+             * uint64_t.
+             *
+             * \param matrix Matrix to fill.
+             * \param element Element which contains the matrix to read.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            static bool readMatrix( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const matrix,
+                            const ElementInfo& element, std::ifstream& ifs, const FileInfo& info );
+
+            /**
+             * Reads the n-dim numeric array which is contained by the element into a tensor of rank N.
+             * The layout is column-major like in MATLAB. Singleton dimensions may be added to or removed from the end,
+             * e.g. a 4x3 matrix can be read into a tensor of rank 3 with the dimensions 4x3x1.
+             *
+             * \param tensor Tensor to fill.
+             * \param element Element which contains the array to read.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T, int N >
+            static bool readTensor( Eigen::Tensor< T, N >* const tensor, const ElementInfo& element, std::ifstream& ifs,
+                            const FileInfo& info );
+
+            /**
+             * Reads the numeric data of the element in column-major order and converts it to the scalar type T.
+             * Available for T: see readMatrix().
+             *
+             * \param data Destination with space for size values.
+             * \param size Number of values, must match the number of elements of the array.
+             * \param element Element which contains the array to read.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            static bool readData( T* const data, size_t size, const ElementInfo& element, std::ifstream& ifs,
+                            const FileInfo& info );
+
+            /**
+             * Reads a block of the numeric matrix which is contained by the element, e.g. a time window or some
+             * channels. Only the columns of the block are read and the rows between them are skipped.
+             * Available for T: see readMatrix().
+             *
+             * \param block Matrix to fill with blockRows x blockCols values.
+             * \param startRow First row of the block.
+             * \param startCol First column of the block.
+             * \param blockRows Number of rows of the block.
+             * \param blockCols Number of columns of the block.
+             * \param element Element which contains the matrix to read.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            static bool readBlock( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const block, size_t startRow,
+                            size_t startCol, size_t blockRows, size_t blockCols, const ElementInfo& element,
+                            std::ifstream& ifs, const FileInfo& info );
+
+            /**
+             * Reads a block of the numeric data of the element in column-major order, see readBlock().
+             *
+             * \param data Destination with space for blockRows * blockCols values.
+             * \param startRow First row of the block.
+             * \param startCol First column of the block.
+             * \param blockRows Number of rows of the block.
+             * \param blockCols Number of columns of the block.
+             * \param element Element which contains the array to read.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            template< typename T >
+            static bool readBlockData( T* const data, size_t startRow, size_t startCol, size_t blockRows,
+                            size_t blockCols, const ElementInfo& element, std::ifstream& ifs, const FileInfo& info );
+
+            /**
+             * Gets the dimensions of the array for a tensor of rank N.
+             *
+             * \param dims Array to store N dimensions.
+             * \param rank Rank N of the tensor.
+             * \param element Element which contains the array.
+             * \return false, if the array has more non-singleton dimensions than rank.
+             */
+            static bool getTensorDimensions( Eigen::Index* const dims, int rank, const ElementInfo& element );
+
+            /**
+             * Sets the dimensions of the element, i.e. dims, rows and cols.
+             *
+             * \param element Element to set.
+             * \param dims Dimensions read from the Dimensions Array subelement.
+             * \return false, if a dimension is invalid.
+             */
+            static bool setDimensions( ElementInfo* const element, const std::vector< miINT32_t >& dims );
+
+            /**
+             * Reads the Array Flags, Dimension and Array Name subelements of an array.
+             * The data position of the element is not set, because it depends on the source.
+             *
+             * \param element Element to set.
+             * \param source Source positioned behind the tag of the miMATRIX element.
+             * \param swapBytes True, if the byte order of the file differs from the host.
+             * \param numBytes Stores the number of bytes read from the source, i.e. the offset of the data.
+             * \return true, if successful, false otherwise.
+             */
+            static bool readSubelements( ElementInfo* const element, DataSource* const source, bool swapBytes,
+                            size_t* const numBytes );
+
+            /**
+             * Inflates the miMATRIX element of a miCOMPRESSED element and reads its subelements.
+             * The data position is set to the offset of the data in the uncompressed bytes.
+             *
+             * \param element Element to set.
+             * \param source Source positioned behind the tag of the miCOMPRESSED element.
+             * \param swapBytes True, if the byte order of the file differs from the host.
+             * \return true, if successful, false otherwise.
+             */
+            static bool readCompressedSubelements( ElementInfo* const element, DataSource* const source,
+                            bool swapBytes );
+
             /**
              * Reads the matrix which is contained by the element.
              *
@@ -176,7 +371,8 @@ namespace cppmath
                             std::ifstream& ifs, const FileInfo& info );
 
             /**
-             * Reads the matrix which is contained by the element.
+             * Reads the complex matrix which is contained by the element.
+             * The real and imaginary part are read directly into the interleaved complex values.
              *
              * \param matrix Matrix to fill.
              * \param element Element which contains the matrix to read.
@@ -187,17 +383,50 @@ namespace cppmath
             static bool readMatrixComplex( Eigen::MatrixXcd* const matrix, const ElementInfo& element,
                             std::ifstream& ifs, const FileInfo& info );
 
+            /**
+             * Reads the sparse matrix which is contained by the element.
+             * The row indices (ir), column offsets (jc) and values (pr) are read directly into the compressed storage.
+             *
+             * \param matrix Matrix to fill.
+             * \param element Element which contains the sparse matrix to read.
+             * \param ifs Open input stream to read from.
+             * \param info File information e.g. to handle endian format.
+             * \return true, if successful, false otherwise.
+             */
+            static bool readMatrixSparse( Eigen::SparseMatrix< double >* const matrix, const ElementInfo& element,
+                            std::ifstream& ifs, const FileInfo& info );
+
+            /**
+             * Reads the matrices of the named elements concurrently.
+             * Each thread opens its own input stream, so compressed elements are inflated in parallel.
+             *
+             * \param matrices Vector to store the matrices in the order of the names.
+             * \param names Variable names of the matrices to read.
+             * \param elements Elements retrieved by retrieveDataElements().
+             * \param fileName Path to the MAT-file.
+             * \param info File information e.g. to handle endian format.
+             * \param pool Thread pool to use, if null a pool with the hardware concurrency is created.
+             * \return true, if all matrices were read, false otherwise.
+             */
+            static bool readMatricesDouble( std::vector< Eigen::MatrixXd >* const matrices,
+                            const std::vector< std::string >& names, const std::list< ElementInfo >& elements,
+                            const std::string& fileName, const FileInfo& info, ThreadPool* const pool = NULL );
+
         private:
-            static bool readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes, std::ifstream& ifs );
+            static bool readTagField( mDataType_t* const dataType, mNumBytes_t* const numBytes, std::ifstream& ifs,
+                            bool swapBytes );
 
-            static bool readArraySubelements( ElementInfo* const element, std::ifstream& ifs );
+            /**
+             * Checks that the element contains a numeric array, which can be read.
+             */
+            static bool checkNumericArray( const ElementInfo& element, const FileInfo& info );
 
             static void nextElement( std::ifstream& ifs, const std::streampos& tagStart, size_t numBytes );
         };
 
         /**
          * Low-level writer for MAT-file format.
-         * \attention Does only supports: little endian, 2-dim double matrices, no compression.
+         * \attention Does only supports: little endian, 2-dim double, complex and sparse matrices.
          */
         class MatWriter
         {
@@ -225,9 +454,140 @@ namespace cppmath
             static size_t writeMatrixDouble( std::ofstream& ofs, const Eigen::MatrixXd& matrix,
                             const std::string& arrayName );
 
-        private:
-            static size_t writeTagField( std::ofstream& ofs, const mDataType_t& dataType, const mNumBytes_t numBytes );
+            /**
+             * Writes 2-dim matrix as miCOMPRESSED element to file.
+             * If successful, file position points to the end of the written data.
+             * Otherwise file positions is reset, but bytes are still written!
+             *
+             * \param ofs Open output stream.
+             * \param matrix Matrix to write.
+             * \param arrayName Variable name.
+             * \param level Compression level, 0 (fast) to 9 (small) or -1 for the zlib default.
+             * \return Written bytes.
+             */
+            static size_t writeMatrixDoubleCompressed( std::ofstream& ofs, const Eigen::MatrixXd& matrix,
+                            const std::string& arrayName, int level = -1 );
+
+            /**
+             * Writes a complex 2-dim matrix. The real and imaginary part are de-interleaved in chunks.
+             * If successful, file position points to the end of the written data.
+             * Otherwise file positions is reset, but bytes are still written!
+             *
+             * \param ofs Open output stream.
+             * \param matrix Matrix to write.
+             * \param arrayName Variable name.
+             * \return Written bytes.
+             */
+            static size_t writeMatrixComplex( std::ofstream& ofs, const Eigen::MatrixXcd& matrix,
+                            const std::string& arrayName );
+
+            /**
+             * Writes a sparse matrix with row indices (ir), column offsets (jc) and values (pr) from its
+             * compressed storage. If successful, file position points to the end of the written data.
+             * Otherwise file positions is reset, but bytes are still written!
+             * Nothing is written, if the element exceeds the maximum size of 4 GiB.
+             *
+             * \param ofs Open output stream.
+             * \param matrix Sparse matrix to write.
+             * \param arrayName Variable name.
+             * \return Written bytes.
+             */
+            static size_t writeMatrixSparse( std::ofstream& ofs, const Eigen::SparseMatrix< double >& matrix,
+                            const std::string& arrayName );
+
+            /**
+             * Writes a tag field.
+             *
+             * \param os Open output stream.
+             * \param dataType Data type of the element.
+             * \param numBytes Number of bytes of the element data.
+             * \return Written bytes, 0 on error.
+             */
+            static size_t writeTagField( std::ostream& os, const mDataType_t& dataType, const mNumBytes_t numBytes );
+
+            /**
+             * Writes the Array Flags, Dimension and Array Name subelements of a 2-dim matrix.
+             *
+             * \param os Open output stream.
+             * \param arrayFlags Flags and class of the array.
+             * \param rows Number of rows.
+             * \param cols Number of columns.
+             * \param arrayName Variable name.
+             * \param nzmax Maximum number of non-zero elements, only for sparse arrays.
+             * \return Written bytes, 0 on error.
+             */
+            static size_t writeArraySubelements( std::ostream& os, const mArrayFlags_t& arrayFlags,
+                            const miINT32_t rows, const miINT32_t cols, const std::string& arrayName,
+                            const miUINT32_t nzmax = 0 );
+
+            /**
+             * Writes the Array Flags, Dimension and Array Name subelements of a n-dim array.
+             *
+             * \param os Open output stream.
+             * \param arrayFlags Flags and class of the array.
+             * \param dims Dimensions, at least 2.
+             * \param arrayName Variable name.
+             * \param nzmax Maximum number of non-zero elements, only for sparse arrays.
+             * \return Written bytes, 0 on error.
+             */
+            static size_t writeArraySubelements( std::ostream& os, const mArrayFlags_t& arrayFlags,
+                            const std::vector< miINT32_t >& dims, const std::string& arrayName,
+                            const miUINT32_t nzmax = 0 );
+
+            /**
+             * Writes the padding to a multiple of 8 bytes.
+             *
+             * \param os Open output stream.
+             * \param numBytes Number of bytes of the element data.
+             * \return Written bytes.
+             */
+            static size_t writePadding( std::ostream& os, size_t numBytes );
         };
+
+        template< typename T >
+        inline bool MatReader::readMatrix( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const matrix,
+                        const ElementInfo& element, std::ifstream& ifs, const FileInfo& info )
+        {
+            if( matrix == NULL )
+            {
+                log::error( CLASS ) << "Matrix object is null!";
+                return false;
+            }
+            matrix->resize( element.rows, element.cols );
+            return readData( matrix->data(), matrix->size(), element, ifs, info );
+        }
+
+        template< typename T >
+        inline bool MatReader::readBlock( Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >* const block,
+                        size_t startRow, size_t startCol, size_t blockRows, size_t blockCols,
+                        const ElementInfo& element, std::ifstream& ifs, const FileInfo& info )
+        {
+            if( block == NULL )
+            {
+                log::error( CLASS ) << "Matrix object is null!";
+                return false;
+            }
+            block->resize( blockRows, blockCols );
+            return readBlockData( block->data(), startRow, startCol, blockRows, blockCols, element, ifs, info );
+        }
+
+        template< typename T, int N >
+        inline bool MatReader::readTensor( Eigen::Tensor< T, N >* const tensor, const ElementInfo& element,
+                        std::ifstream& ifs, const FileInfo& info )
+        {
+            if( tensor == NULL )
+            {
+                log::error( CLASS ) << "Tensor object is null!";
+                return false;
+            }
+            Eigen::array< Eigen::Index, N > dims;
+            if( !getTensorDimensions( dims.data(), N, element ) )
+            {
+                return false;
+            }
+            tensor->resize( dims );
+            return readData( tensor->data(), tensor->size(), element, ifs, info );
+        }
     } /* namespace matlab */
 } /* namespace cppmath */
 
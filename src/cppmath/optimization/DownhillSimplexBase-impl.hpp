@@ -0,0 +1,291 @@
+#ifndef CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXBASE_IMPL_HPP_
+#define CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXBASE_IMPL_HPP_
+
+#include <cassert>
+
+#include "DownhillSimplexBase.hpp"
+
+namespace cppmath
+{
+    template< int DIM >
+    DownhillSimplexBase< DIM >::DownhillSimplexBase( size_t dimension ) :
+                    DIMENSION( dimension ), VALUES( dimension + 1 )
+    {
+        assert( DIM == Eigen::Dynamic || DIM == static_cast< int >( dimension ) );
+        assert( dimension > 0 );
+        m_x.resize( DIMENSION, VALUES );
+        m_f.resize( VALUES );
+        m_idx.resize( VALUES );
+
+        m_initFactor = 2.0;
+        m_maxIterations = 200 * DIMENSION;
+        m_iterations = 0;
+        m_evaluations = 0;
+        m_epsilon = 1e-4;
+        m_pool = NULL;
+    }
+
+    template< int DIM >
+    DownhillSimplexBase< DIM >::~DownhillSimplexBase()
+    {
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::funcBatch( Eigen::VectorXd* const values, const ParamsBatchT& points ) const
+    {
+        values->resize( points.cols() );
+        if( m_pool != NULL )
+        {
+            m_pool->parallelFor( points.cols(), [&]( size_t i )
+            {
+                ( *values )( i ) = func( points.col( i ) );
+            } );
+            return;
+        }
+        for( typename ParamsBatchT::Index i = 0; i < points.cols(); ++i )
+        {
+            ( *values )( i ) = func( points.col( i ) );
+        }
+    }
+
+    template< int DIM >
+    size_t DownhillSimplexBase< DIM >::getMaximumIterations() const
+    {
+        return m_maxIterations;
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::setMaximumIterations( size_t iterations )
+    {
+        m_maxIterations = iterations;
+    }
+
+    template< int DIM >
+    double DownhillSimplexBase< DIM >::getEpsilon() const
+    {
+        return m_epsilon;
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::setEpsilon( double eps )
+    {
+        m_epsilon = eps;
+    }
+
+    template< int DIM >
+    double DownhillSimplexBase< DIM >::getInitialFactor() const
+    {
+        return m_initFactor;
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::setInitialFactor( double factor )
+    {
+        m_initFactor = factor;
+    }
+
+    template< int DIM >
+    SimplexConvergence& DownhillSimplexBase< DIM >::getConvergence()
+    {
+        return m_convergence;
+    }
+
+    template< int DIM >
+    const SimplexConvergence& DownhillSimplexBase< DIM >::getConvergence() const
+    {
+        return m_convergence;
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::setConvergence( const SimplexConvergence& convergence )
+    {
+        m_convergence = convergence;
+    }
+
+    template< int DIM >
+    EvaluationCache& DownhillSimplexBase< DIM >::getCache()
+    {
+        return m_cache;
+    }
+
+    template< int DIM >
+    const EvaluationCache& DownhillSimplexBase< DIM >::getCache() const
+    {
+        return m_cache;
+    }
+
+    template< int DIM >
+    ThreadPool* DownhillSimplexBase< DIM >::getThreadPool() const
+    {
+        return m_pool;
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::setThreadPool( ThreadPool* const pool )
+    {
+        m_pool = pool;
+    }
+
+    template< int DIM >
+    size_t DownhillSimplexBase< DIM >::getResultIterations() const
+    {
+        return m_iterations;
+    }
+
+    template< int DIM >
+    size_t DownhillSimplexBase< DIM >::getResultEvaluations() const
+    {
+        return m_evaluations;
+    }
+
+    template< int DIM >
+    const SimplexStatistics& DownhillSimplexBase< DIM >::getStatistics() const
+    {
+        return m_statistics;
+    }
+
+    template< int DIM >
+    typename DownhillSimplexBase< DIM >::ParamsT DownhillSimplexBase< DIM >::getResultParams() const
+    {
+        return m_x.col( m_idx( 0 ) );
+    }
+
+    template< int DIM >
+    double DownhillSimplexBase< DIM >::getResultError() const
+    {
+        return m_f( m_idx( 0 ) );
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::order()
+    {
+        // The ordering is used in reflection() and for min/max.
+        // Insertionsort of the indices, the points are not moved.
+        for( size_t i = 1; i < VALUES; ++i )
+        {
+            const int idx_insert = m_idx( i );
+            const double y_insert = m_f( idx_insert );
+            size_t j = i;
+            while( j > 0 && m_f( m_idx( j - 1 ) ) > y_insert )
+            {
+                m_idx( j ) = m_idx( j - 1 );
+                --j;
+            }
+            m_idx( j ) = idx_insert;
+        }
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::orderWorst()
+    {
+        // Single backward pass of the insertionsort for the last index.
+        const int idx_insert = m_idx( VALUES - 1 );
+        const double y_insert = m_f( idx_insert );
+        size_t j = VALUES - 1;
+        while( j > 0 && m_f( m_idx( j - 1 ) ) > y_insert )
+        {
+            m_idx( j ) = m_idx( j - 1 );
+            --j;
+        }
+        m_idx( j ) = idx_insert;
+    }
+
+    template< int DIM >
+    typename DownhillSimplexBase< DIM >::Converged DownhillSimplexBase< DIM >::converged() const
+    {
+        if( m_iterations >= m_maxIterations )
+        {
+            return CONVERGED_ITERATIONS;
+        }
+        if( m_f( m_idx( 0 ) ) <= m_epsilon )
+        {
+            return CONVERGED_EPSILON;
+        }
+        switch( m_convergence.check( m_x, m_f, m_idx, m_evaluations ) )
+        {
+            case SimplexConvergence::CRITERION_SPREAD:
+                return CONVERGED_SPREAD;
+            case SimplexConvergence::CRITERION_DIAMETER:
+                return CONVERGED_DIAMETER;
+            case SimplexConvergence::CRITERION_RELATIVE:
+                return CONVERGED_RELATIVE;
+            case SimplexConvergence::CRITERION_TIME:
+                return CONVERGED_TIME;
+            case SimplexConvergence::CRITERION_EVALUATIONS:
+                return CONVERGED_EVALUATIONS;
+            default:
+                return CONVERGED_NO;
+        }
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::start()
+    {
+        m_iterations = 0;
+        m_evaluations = 0;
+        m_convergence.start();
+        m_statistics.start();
+    }
+
+    template< int DIM >
+    double DownhillSimplexBase< DIM >::evaluate( const ParamsT& x )
+    {
+        double f;
+        if( m_cache.lookup( &f, x.data(), x.size() ) )
+        {
+            return f;
+        }
+
+        ++m_evaluations;
+        const SimplexStatistics::TimePointT start = SimplexStatistics::now();
+        f = func( x );
+        m_statistics.addEvaluations( 1, start );
+        m_cache.insert( x.data(), x.size(), f );
+        return f;
+    }
+
+    template< int DIM >
+    void DownhillSimplexBase< DIM >::evaluateBatch( Eigen::VectorXd* const values, const ParamsBatchT& points )
+    {
+        if( !m_cache.isEnabled() )
+        {
+            m_evaluations += points.cols();
+            const SimplexStatistics::TimePointT start = SimplexStatistics::now();
+            funcBatch( values, points );
+            m_statistics.addEvaluations( points.cols(), start );
+            return;
+        }
+
+        // Evaluate only the points, which are not cached.
+        values->resize( points.cols() );
+        m_misses.clear();
+        for( typename ParamsBatchT::Index i = 0; i < points.cols(); ++i )
+        {
+            if( !m_cache.lookup( &( *values )( i ), points.col( i ).data(), DIMENSION ) )
+            {
+                m_misses.push_back( i );
+            }
+        }
+        if( m_misses.empty() )
+        {
+            return;
+        }
+
+        m_missBatch.resize( DIMENSION, m_misses.size() );
+        for( size_t i = 0; i < m_misses.size(); ++i )
+        {
+            m_missBatch.col( i ) = points.col( m_misses[i] );
+        }
+        m_evaluations += m_misses.size();
+        const SimplexStatistics::TimePointT start = SimplexStatistics::now();
+        funcBatch( &m_missValues, m_missBatch );
+        m_statistics.addEvaluations( m_misses.size(), start );
+        for( size_t i = 0; i < m_misses.size(); ++i )
+        {
+            ( *values )( m_misses[i] ) = m_missValues( i );
+            m_cache.insert( m_missBatch.col( i ).data(), DIMENSION, m_missValues( i ) );
+        }
+    }
+} /* namespace cppmath */
+
+#endif  // CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXBASE_IMPL_HPP_
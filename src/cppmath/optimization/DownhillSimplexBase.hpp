@@ -0,0 +1,214 @@
+#ifndef CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXBASE_HPP_
+#define CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXBASE_HPP_
+
+#include <cstddef> // size_t
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "../concurrent/ThreadPool.hpp"
+#include "EvaluationCache.hpp"
+#include "SimplexConvergence.hpp"
+#include "SimplexStatistics.hpp"
+
+namespace cppmath
+{
+    /**
+     * Common base of the Downhill Simplex methods. It stores the simplex and provides the function evaluation with
+     * cache, thread pool and statistics, the ordering of the points and the convergence check.
+     * The steps of the method are implemented by the derived classes.
+     *
+     * \author cpieloth
+     * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+     */
+    template< int DIM >
+    class DownhillSimplexBase
+    {
+    public:
+        typedef Eigen::Matrix< double, DIM, 1 > ParamsT; /**< Abbreviation for a vector of parameters. */
+        typedef Eigen::Matrix< double, DIM, Eigen::Dynamic > ParamsBatchT; /**< Parameter vectors as columns. */
+
+        static const int VALUES_DIM = DIM == Eigen::Dynamic ? Eigen::Dynamic : DIM + 1; /**< Compile-time DIM+1. */
+        typedef Eigen::Matrix< double, DIM, VALUES_DIM > SimplexT; /**< All n+1 points as columns. */
+        typedef Eigen::Matrix< double, VALUES_DIM, 1 > ValuesT; /**< Function values of all n+1 points. */
+        typedef Eigen::Matrix< int, VALUES_DIM, 1 > IndicesT; /**< Indices of all n+1 points. */
+
+        /**
+         * Enum to indicate how the optimization was converged.
+         */
+        enum Converged
+        {
+            CONVERGED_NO, /**< Optimization was not started. */
+            CONVERGED_EPSILON, /**< Optimization is smaller than epsilon/threshold. */
+            CONVERGED_ITERATIONS, /**< Maximum iterations was reached. */
+            CONVERGED_YES, /**< Optimization is converged, but not specified how. */
+            CONVERGED_SPREAD, /**< Spread of the function values is smaller than the threshold. */
+            CONVERGED_DIAMETER, /**< Diameter of the simplex is smaller than the threshold. */
+            CONVERGED_RELATIVE, /**< Relative spread of the function values is smaller than the threshold. */
+            CONVERGED_TIME, /**< Time budget is exceeded. */
+            CONVERGED_EVALUATIONS /**< Evaluation budget is exceeded. */
+        };
+
+        /**
+         * Constructor.
+         *
+         * \param dimension Dimension of the parameter vector, must be equal to DIM for a fixed dimension.
+         */
+        explicit DownhillSimplexBase( size_t dimension );
+        virtual ~DownhillSimplexBase();
+
+        /**
+         * Implementation of the function to minimize.
+         *
+         * \param x  n-dimensional parameter vector.
+         * \return function value for vector x.
+         */
+        virtual double func( const ParamsT& x ) const = 0;
+
+        /**
+         * Evaluates the function for several points at once, e.g. by a vectorized implementation.
+         * The default implementation calls func() for each point, concurrently if a thread pool is set.
+         *
+         * \param values Stores the function value for each column of points.
+         * \param points n-dimensional parameter vectors as columns.
+         */
+        virtual void funcBatch( Eigen::VectorXd* const values, const ParamsBatchT& points ) const;
+
+        size_t getMaximumIterations() const;
+
+        void setMaximumIterations( size_t iterations );
+
+        double getEpsilon() const;
+
+        void setEpsilon( double eps );
+
+        double getInitialFactor() const;
+
+        void setInitialFactor( double factor );
+
+        /**
+         * Returns the optional convergence criteria, which are checked in addition to maximum iterations and epsilon.
+         *
+         * \return Convergence criteria to modify.
+         */
+        SimplexConvergence& getConvergence();
+
+        const SimplexConvergence& getConvergence() const;
+
+        void setConvergence( const SimplexConvergence& convergence );
+
+        /**
+         * Returns the cache of function values, which is disabled by default. Enable it by setting a capacity.
+         * The cache is kept between optimizations and provides the hit and miss counters.
+         *
+         * \return Cache to modify.
+         */
+        EvaluationCache& getCache();
+
+        const EvaluationCache& getCache() const;
+
+        ThreadPool* getThreadPool() const;
+
+        /**
+         * Sets a thread pool to evaluate the independent points of createInitials() and the shrinkage concurrently.
+         * \attention func() must be thread-safe, if a thread pool is set.
+         *
+         * \param pool Thread pool or NULL to evaluate sequentially (default).
+         */
+        void setThreadPool( ThreadPool* const pool );
+
+        size_t getResultIterations() const;
+
+        /**
+         * Returns the number of function evaluations of the last optimization.
+         *
+         * \return Number of evaluated points.
+         */
+        size_t getResultEvaluations() const;
+
+        /**
+         * Returns the statistics of the last optimization, e.g. evaluations, steps and timings.
+         *
+         * \return Statistics record.
+         */
+        const SimplexStatistics& getStatistics() const;
+
+        ParamsT getResultParams() const;
+
+        double getResultError() const;
+
+    protected:
+        /**
+         * Orders the indices of x by f(x) from min to max. The points itself are not moved.
+         * Used for the initial simplex and after a shrinkage, when all points but the best are new.
+         */
+        virtual void order();
+
+        /**
+         * Moves the index of the worst point to its position, after this point was replaced.
+         * The other indices must be ordered, so at most DIM comparisons are needed.
+         */
+        void orderWorst();
+
+        /**
+         * Checks if the optimization has been converged.
+         *
+         * \return Enum::Converged
+         */
+        virtual Converged converged() const;
+
+        /**
+         * Resets the counters, convergence criteria and statistics for a new optimization.
+         */
+        void start();
+
+        /**
+         * Evaluates func(), if the value is not cached, and counts the evaluation.
+         *
+         * \param x n-dimensional parameter vector.
+         * \return function value for vector x.
+         */
+        double evaluate( const ParamsT& x );
+
+        /**
+         * Evaluates funcBatch() for all points, which are not cached, and counts the evaluations.
+         *
+         * \param values Stores the function value for each column of points.
+         * \param points n-dimensional parameter vectors as columns.
+         */
+        void evaluateBatch( Eigen::VectorXd* const values, const ParamsBatchT& points );
+
+        double m_initFactor; /**< Factor to create the initial parameter set. */
+
+        SimplexT m_x; /**< All n+1 points as columns, not ordered. */
+        ValuesT m_f; /**< Stores the function values of the columns to reduce re-calculation. */
+        IndicesT m_idx; /**< Column indices of the points ordered by f(x) from min to max. */
+
+        double m_epsilon; /**< Threshold or deviation for convergence. */
+        size_t m_maxIterations; /**< Maximum iterations until the algorithm is canceled. */
+        size_t m_iterations; /**< Iteration counter used for break condition. */
+        size_t m_evaluations; /**< Evaluation counter used for break condition. */
+
+        SimplexConvergence m_convergence; /**< Optional convergence criteria. */
+        EvaluationCache m_cache; /**< Optional cache of function values. */
+        SimplexStatistics m_statistics; /**< Statistics of the last optimization. */
+
+        const size_t DIMENSION; /**< Constant for dimension. */
+        const size_t VALUES; /**< Constant for DIM+1. */
+
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    private:
+        ThreadPool* m_pool; /**< Optional thread pool for batch evaluations. */
+
+        ParamsBatchT m_missBatch; /**< Buffer for points of a batch, which are not cached. */
+        Eigen::VectorXd m_missValues; /**< Buffer for points of a batch, which are not cached. */
+        std::vector< size_t > m_misses; /**< Buffer for indices of a batch, which are not cached. */
+    };
+} /* namespace cppmath */
+
+// Load the implementation
+#include "DownhillSimplexBase-impl.hpp"
+
+#endif  // CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXBASE_HPP_
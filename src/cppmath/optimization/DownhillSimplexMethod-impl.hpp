@@ -10,173 +10,124 @@
 
 namespace cppmath
 {
-    template< size_t DIM >
+    template< int DIM >
     DownhillSimplexMethod< DIM >::DownhillSimplexMethod() :
-                    N( DIM - 1 ), N1( DIM ), DIMENSION( DIM ), VALUES( DIM + 1 )
+                    DownhillSimplexMethod( DIM )
     {
+        static_assert( DIM != Eigen::Dynamic, "Dimension must be passed for Eigen::Dynamic!" );
+    }
+
+    template< int DIM >
+    DownhillSimplexMethod< DIM >::DownhillSimplexMethod( size_t dimension ) :
+                    BaseT( dimension ), N( dimension - 1 ), N1( dimension )
+    {
+        m_xo.resize( DIMENSION );
+        m_xr.resize( DIMENSION );
+        m_xsum.resize( DIMENSION );
+        m_updates = 0;
+
         m_refl = 1.0;
         m_contr = 0.5;
         m_exp = 2.0;
         m_shri = 0.5;
 
-        m_initFactor = 2.0;
-
-        m_maxIterations = 200 * DIM;
-        m_iterations = 0;
-        m_epsilon = 1e-4;
         m_fr = 0.0;
+        m_speculative = false;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     DownhillSimplexMethod< DIM >::~DownhillSimplexMethod()
     {
     }
 
-    template< size_t DIM >
-    typename DownhillSimplexMethod< DIM >::Converged DownhillSimplexMethod< DIM >::converged() const
-    {
-        if( m_iterations >= m_maxIterations )
-        {
-            return CONVERGED_ITERATIONS;
-        }
-        if( func( m_x[0] ) <= m_epsilon )
-        {
-            return CONVERGED_EPSILON;
-        }
-        return CONVERGED_NO;
-    }
-
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethod< DIM >::getReflectionCoeff() const
     {
         return m_refl;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::setReflectionCoeff( double coeff )
     {
         m_refl = coeff;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethod< DIM >::getContractionCoeff() const
     {
         return m_contr;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::setContractionCoeff( double coeff )
     {
         m_contr = coeff;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethod< DIM >::getExpansionCoeff() const
     {
         return m_exp;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::setExpansionCoeff( double coeff )
     {
         m_exp = coeff;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethod< DIM >::getShrinkageCoeff() const
     {
         return m_shri;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::setShrinkageCoeff( double coeff )
     {
         m_shri = coeff;
     }
 
-    template< size_t DIM >
-    size_t DownhillSimplexMethod< DIM >::getMaximumIterations() const
+    template< int DIM >
+    bool DownhillSimplexMethod< DIM >::isSpeculative() const
     {
-        return m_maxIterations;
+        return m_speculative;
     }
 
-    template< size_t DIM >
-    void DownhillSimplexMethod< DIM >::setMaximumIterations( size_t iterations )
+    template< int DIM >
+    void DownhillSimplexMethod< DIM >::setSpeculative( bool speculative )
     {
-        m_maxIterations = iterations;
+        m_speculative = speculative;
     }
 
-    template< size_t DIM >
-    double DownhillSimplexMethod< DIM >::getEpsilon() const
-    {
-        return m_epsilon;
-    }
-
-    template< size_t DIM >
-    void DownhillSimplexMethod< DIM >::setEpsilon( double eps )
-    {
-        m_epsilon = eps;
-    }
-
-    template< size_t DIM >
-    double DownhillSimplexMethod< DIM >::getInitialFactor() const
-    {
-        return m_initFactor;
-    }
-
-    template< size_t DIM >
-    void DownhillSimplexMethod< DIM >::setInitialFactor( double factor )
-    {
-        m_initFactor = factor;
-    }
-
-    template< size_t DIM >
-    size_t DownhillSimplexMethod< DIM >::getResultIterations() const
-    {
-        return m_iterations;
-    }
-
-    template< size_t DIM >
-    typename DownhillSimplexMethod< DIM >::ParamsT DownhillSimplexMethod< DIM >::getResultParams() const
-    {
-        return m_x[0];
-    }
-
-    template< size_t DIM >
-    double DownhillSimplexMethod< DIM >::getResultError() const
-    {
-        return m_f[0];
-    }
-
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::createInitials( const ParamsT& initial )
     {
         const double zero_term_delta = 0.00025; // delta for zero elements of x
 
-        m_x[0] = initial;
+        m_batch.resize( DIMENSION, VALUES );
+        m_batch.col( 0 ) = initial;
         typename ParamsT::Index dim = 0;
         for( size_t i = 1; i < VALUES; ++i )
         {
-            ParamsT p = initial;
-            if( p( dim ) != 0 )
+            m_batch.col( i ) = initial;
+            if( initial( dim ) != 0 )
             {
-                p( dim ) = m_initFactor * p( dim );
+                m_batch( dim, i ) = m_initFactor * initial( dim );
             }
             else
             {
-                p( dim ) = zero_term_delta;
+                m_batch( dim, i ) = zero_term_delta;
             }
-            m_x[i] = p;
             ++dim;
         }
 
-        for( size_t i = 0; i < VALUES; ++i )
-        {
-            m_f[i] = func( m_x[i] );
-        }
+        evaluateBatch( &m_batchValues, m_batch );
+        m_x = m_batch;
+        m_f = m_batchValues;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethod< DIM >::Converged DownhillSimplexMethod< DIM >::optimize( const ParamsT& initial )
     {
         assert( m_refl > 0.0 );
@@ -187,26 +138,32 @@ namespace cppmath
         assert( m_initFactor > 0.0 );
 
         // Prepare optimization
-        m_iterations = 0;
+        start();
         createInitials( initial );
+        for( size_t i = 0; i < VALUES; ++i )
+        {
+            m_idx( i ) = i;
+        }
+        order();
+        updateSum();
 
-        Converged conv = CONVERGED_NO;
+        Converged conv = BaseT::CONVERGED_NO;
         Step next = STEP_START;
         while( next != STEP_EXIT )
         {
             switch( next )
             {
                 case STEP_START:
-                    order();
+                    m_statistics.addBest( m_f( m_idx( 0 ) ) );
                     conv = converged();
-                    if( conv != CONVERGED_NO )
+                    if( conv != BaseT::CONVERGED_NO )
                     {
                         next = STEP_EXIT;
                         break;
                     }
                     ++m_iterations;
                     centroid();
-                    next = STEP_REFLECTION;
+                    next = m_speculative ? STEP_SPECULATION : STEP_REFLECTION;
                     break;
                 case STEP_REFLECTION:
                     next = reflection();
@@ -220,6 +177,9 @@ namespace cppmath
                 case STEP_SHRINKAGE:
                     next = shrinkage();
                     break;
+                case STEP_SPECULATION:
+                    next = speculation();
+                    break;
                 default:
                     std::cerr << "Undefined control flow!";
                     next = STEP_EXIT;
@@ -227,61 +187,54 @@ namespace cppmath
             }
         }
 
+        m_statistics.stop();
         return conv;
     }
 
-    template< size_t DIM >
-    void DownhillSimplexMethod< DIM >::order()
+    template< int DIM >
+    void DownhillSimplexMethod< DIM >::updateSum()
     {
-        // The ordering is used in reflection() and for min/max.
-        // Insertionsort
-        for( size_t i = 1; i < VALUES; ++i )
-        {
-            const ParamsT x_insert = m_x[i];
-            const double y_insert = m_f[i];
-            size_t j = i;
-            while( j > 0 && m_f[j - 1] > y_insert )
-            {
-                m_x[j] = m_x[j - 1];
-                m_f[j] = m_f[j - 1];
-                --j;
-            }
-            m_x[j] = x_insert;
-            m_f[j] = y_insert;
-        }
+        m_xsum = m_x.rowwise().sum();
+        m_updates = 0;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::centroid()
     {
-        ParamsT xo = ParamsT::Zero();
-        for( size_t i = 0; i <= N; ++i )
-        {
-            xo += m_x[i];
-        }
-        m_xo = xo / DIM;
+        // Centroid of all points except the worst one, the sum of all points is updated incrementally.
+        m_xo = ( m_xsum - m_x.col( m_idx( N1 ) ) ) / static_cast< double >( DIMENSION );
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethod< DIM >::accept( const ParamsT& x, double f )
     {
-        m_x[N1] = x;
-        m_f[N1] = f;
+        const int worst = m_idx( N1 );
+        m_xsum += x - m_x.col( worst );
+        m_x.col( worst ) = x;
+        m_f( worst ) = f;
+        orderWorst();
+
+        // Recompute the sum from time to time to avoid an accumulation of rounding errors.
+        if( ++m_updates >= VALUES )
+        {
+            updateSum();
+        }
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethod< DIM >::Step DownhillSimplexMethod< DIM >::reflection()
     {
-        m_xr = m_xo + m_refl * ( m_xo - m_x[N1] );
-        m_fr = func( m_xr );
+        m_xr = m_xo + m_refl * ( m_xo - m_x.col( m_idx( N1 ) ) );
+        m_fr = evaluate( m_xr );
         const double f_r = m_fr;
-        const double f_1 = m_f[0];
-        const double f_n = m_f[N];
+        const double f_1 = m_f( m_idx( 0 ) );
+        const double f_n = m_f( m_idx( N ) );
 
         if( f_1 <= f_r && f_r < f_n )
         {
             const ParamsT& x_r = m_xr;
             accept( x_r, f_r );
+            m_statistics.addStep( SimplexStatistics::STEP_REFLECTION );
             return STEP_START;
         }
 
@@ -298,11 +251,11 @@ namespace cppmath
         return STEP_EXIT;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethod< DIM >::Step DownhillSimplexMethod< DIM >::expansion()
     {
         const ParamsT x_e = m_xo + m_exp * ( m_xr - m_xo );
-        const double f_e = func( x_e );
+        const double f_e = evaluate( x_e );
         const double f_r = m_fr;
 
         if( f_e < f_r )
@@ -314,26 +267,28 @@ namespace cppmath
             const ParamsT& x_r = m_xr;
             accept( x_r, f_r );
         }
+        m_statistics.addStep( SimplexStatistics::STEP_EXPANSION );
         return STEP_START;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethod< DIM >::Step DownhillSimplexMethod< DIM >::contraction()
     {
         const double f_r = m_fr;
-        const double f_n = m_f[N];
-        const double f_n1 = m_f[N1];
+        const double f_n = m_f( m_idx( N ) );
+        const double f_n1 = m_f( m_idx( N1 ) );
 
         // outside contraction
         if( f_n <= f_r && f_r < f_n1 )
         {
             const ParamsT& x_r = m_xr;
             const ParamsT x_c = m_xo + m_contr * ( x_r - m_xo );
-            const double y_c = func( x_c );
+            const double y_c = evaluate( x_c );
 
             if( y_c <= f_r )
             {
                 accept( x_c, y_c );
+                m_statistics.addStep( SimplexStatistics::STEP_CONTRACTION );
                 return STEP_START;
             }
             else
@@ -345,13 +300,14 @@ namespace cppmath
         // inside contraction
         if( f_r >= f_n1 )
         {
-            const ParamsT& x_n1 = m_x[N1];
+            const ParamsT& x_n1 = m_x.col( m_idx( N1 ) );
             const ParamsT x_cc = m_xo - m_contr * ( m_xo - x_n1 );
-            const double fcc = func( x_cc );
+            const double fcc = evaluate( x_cc );
 
             if( fcc <= f_r )
             {
                 accept( x_cc, fcc );
+                m_statistics.addStep( SimplexStatistics::STEP_CONTRACTION );
                 return STEP_START;
             }
             else
@@ -363,19 +319,101 @@ namespace cppmath
         return STEP_EXIT;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethod< DIM >::Step DownhillSimplexMethod< DIM >::shrinkage()
     {
-        const ParamsT& x_1 = m_x[0];
+        const ParamsT x_1 = m_x.col( m_idx( 0 ) );
+        m_batch.resize( DIMENSION, N1 );
         for( size_t i = 1; i <= N1; ++i )
         {
-            m_x[i] = x_1 + m_shri * ( m_x[i] - x_1 );
-            m_f[i] = func( m_x[i] );
+            m_batch.col( i - 1 ) = x_1 + m_shri * ( m_x.col( m_idx( i ) ) - x_1 );
         }
 
+        evaluateBatch( &m_batchValues, m_batch );
+        for( size_t i = 1; i <= N1; ++i )
+        {
+            m_x.col( m_idx( i ) ) = m_batch.col( i - 1 );
+            m_f( m_idx( i ) ) = m_batchValues( i - 1 );
+        }
+        order();
+        updateSum();
+        m_statistics.addStep( SimplexStatistics::STEP_SHRINKAGE );
+
         // TODO(cpieloth): nonshrink ordering rule, shrink ordering rule
         return STEP_START;
     }
+
+    template< int DIM >
+    typename DownhillSimplexMethod< DIM >::Step DownhillSimplexMethod< DIM >::speculation()
+    {
+        // Compute all candidates up front, see reflection(), expansion() and contraction() for the sequential logic.
+        const ParamsT& x_n1 = m_x.col( m_idx( N1 ) );
+        m_xr = m_xo + m_refl * ( m_xo - x_n1 );
+        m_batch.resize( DIMENSION, 4 );
+        m_batch.col( 0 ) = m_xr;
+        m_batch.col( 1 ) = m_xo + m_exp * ( m_xr - m_xo );
+        m_batch.col( 2 ) = m_xo + m_contr * ( m_xr - m_xo );
+        m_batch.col( 3 ) = m_xo - m_contr * ( m_xo - x_n1 );
+        evaluateBatch( &m_batchValues, m_batch );
+
+        m_fr = m_batchValues( 0 );
+        const double f_r = m_fr;
+        const double f_e = m_batchValues( 1 );
+        const double f_oc = m_batchValues( 2 );
+        const double f_ic = m_batchValues( 3 );
+        const double f_1 = m_f( m_idx( 0 ) );
+        const double f_n = m_f( m_idx( N ) );
+        const double f_n1 = m_f( m_idx( N1 ) );
+
+        // reflection
+        if( f_1 <= f_r && f_r < f_n )
+        {
+            accept( m_xr, f_r );
+            m_statistics.addStep( SimplexStatistics::STEP_REFLECTION );
+            return STEP_START;
+        }
+
+        // expansion
+        if( f_r < f_1 )
+        {
+            if( f_e < f_r )
+            {
+                accept( m_batch.col( 1 ), f_e );
+            }
+            else
+            {
+                accept( m_xr, f_r );
+            }
+            m_statistics.addStep( SimplexStatistics::STEP_EXPANSION );
+            return STEP_START;
+        }
+
+        // outside contraction
+        if( f_n <= f_r && f_r < f_n1 )
+        {
+            if( f_oc <= f_r )
+            {
+                accept( m_batch.col( 2 ), f_oc );
+                m_statistics.addStep( SimplexStatistics::STEP_CONTRACTION );
+                return STEP_START;
+            }
+            return STEP_SHRINKAGE;
+        }
+
+        // inside contraction
+        if( f_r >= f_n1 )
+        {
+            if( f_ic <= f_r )
+            {
+                accept( m_batch.col( 3 ), f_ic );
+                m_statistics.addStep( SimplexStatistics::STEP_CONTRACTION );
+                return STEP_START;
+            }
+            return STEP_SHRINKAGE;
+        }
+
+        return STEP_EXIT;
+    }
 } /* namespace cppmath */
 
 #endif  // CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMETHOD_IMPL_HPP_
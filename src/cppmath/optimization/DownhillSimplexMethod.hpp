@@ -5,6 +5,8 @@
 
 #include <Eigen/Dense>
 
+#include "DownhillSimplexBase.hpp"
+
 namespace cppmath
 {
     /**
@@ -13,36 +15,33 @@ namespace cppmath
      * "Convergence Properties of the Nelder-Mead Simplex Method in Low Dimensions,"
      * SIAM Journal of Optimization, 1998, 9, 112-147
      *
+     * DIM can be Eigen::Dynamic to choose the dimension at runtime, see constructor. Fixed dimensions keep all data on
+     * the stack. The simplex is stored as a contiguous column-major matrix in both cases.
+     *
      * \author cpieloth
      * \copyright Copyright 2014 Christof Pieloth, Licensed under the Apache License, Version 2.0
      */
-    template< size_t DIM >
-    class DownhillSimplexMethod
+    template< int DIM >
+    class DownhillSimplexMethod: public DownhillSimplexBase< DIM >
     {
     public:
-        typedef Eigen::Matrix< double, DIM, 1 > ParamsT; /**< Abbreviation for a vector of parameters. */
+        typedef DownhillSimplexBase< DIM > BaseT; /**< Abbreviation for the base class. */
+        typedef typename BaseT::ParamsT ParamsT; /**< Abbreviation for a vector of parameters. */
+        typedef typename BaseT::ParamsBatchT ParamsBatchT; /**< Parameter vectors as columns. */
+        typedef typename BaseT::Converged Converged; /**< Enum to indicate how the optimization was converged. */
 
         /**
-         * Enum to indicate how the optimization was converged.
+         * Constructor for a fixed dimension DIM.
          */
-        enum Converged
-        {
-            CONVERGED_NO, /**< Optimization was not started. */
-            CONVERGED_EPSILON, /**< Optimization is smaller than epsilon/threshold. */
-            CONVERGED_ITERATIONS, /**< Maximum iterations was reached. */
-            CONVERGED_YES /**< Optimization is converged, but not specified how. */
-        };
-
         DownhillSimplexMethod();
-        virtual ~DownhillSimplexMethod();
 
         /**
-         * Implementation of the function to minimize.
+         * Constructor for a dimension given at runtime, e.g. for DIM = Eigen::Dynamic.
          *
-         * \param x  n-dimensional parameter vector.
-         * \return function value for vector x.
+         * \param dimension Dimension of the parameter vector, must be equal to DIM for a fixed dimension.
          */
-        virtual double func( const ParamsT& x ) const = 0;
+        explicit DownhillSimplexMethod( size_t dimension );
+        virtual ~DownhillSimplexMethod();
 
         double getReflectionCoeff() const;
 
@@ -60,23 +59,16 @@ namespace cppmath
 
         void setShrinkageCoeff( double coeff );
 
-        size_t getMaximumIterations() const;
-
-        void setMaximumIterations( size_t iterations );
+        bool isSpeculative() const;
 
-        double getEpsilon() const;
-
-        void setEpsilon( double eps );
-
-        double getInitialFactor() const;
-
-        void setInitialFactor( double factor );
-
-        size_t getResultIterations() const;
-
-        ParamsT getResultParams() const;
-
-        double getResultError() const;
+        /**
+         * Enables the speculative mode: The reflection, expansion, outside and inside contraction points are computed
+         * up front and evaluated with a single funcBatch() call, e.g. concurrently on the thread pool.
+         * The acceptance logic is not changed, but each iteration costs 4 function evaluations.
+         *
+         * \param speculative True to enable the speculative mode, false to disable it (default).
+         */
+        void setSpeculative( bool speculative );
 
         /**
          * Starts the optimization.
@@ -87,18 +79,6 @@ namespace cppmath
         Converged optimize( const ParamsT& initial );
 
     protected:
-        /**
-         * Orders the parameters x and f(x) from min to max.
-         */
-        virtual void order();
-
-        /**
-         * Checks if the optimization has been converged.
-         *
-         * \return Enum::Converged
-         */
-        virtual Converged converged() const;
-
         /**
          * Creates the initial parameter set and their function values.
          *
@@ -106,22 +86,29 @@ namespace cppmath
          */
         virtual void createInitials( const ParamsT& initial );
 
-        double m_initFactor; /**< Factor to create the initial parameter set. */
-
-        ParamsT m_x[DIM + 1]; /**< Vector of all n+1 points. */
-        double m_f[DIM + 1]; /**< Stores the function values to reduce re-calculation. */
+        using BaseT::order;
+        using BaseT::orderWorst;
+        using BaseT::converged;
+        using BaseT::start;
+        using BaseT::evaluate;
+        using BaseT::evaluateBatch;
+
+        using BaseT::m_initFactor;
+        using BaseT::m_x;
+        using BaseT::m_f;
+        using BaseT::m_idx;
+        using BaseT::m_iterations;
+        using BaseT::m_statistics;
+        using BaseT::DIMENSION;
+        using BaseT::VALUES;
 
-        double m_epsilon; /**< Threshold or deviation for convergence. */
-        size_t m_maxIterations; /**< Maximum iterations until the algorithm is canceled. */
-        size_t m_iterations; /**< Iteration counter used for break condition. */
-
-        const size_t DIMENSION; /**< Constant for dimension. */
-        const size_t VALUES; /**< Constant for DIM+1. */
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
     private:
         enum Step
         {
-            STEP_START, STEP_EXIT, STEP_REFLECTION, STEP_EXPANSION, STEP_CONTRACTION, STEP_SHRINKAGE
+            STEP_START, STEP_EXIT, STEP_REFLECTION, STEP_EXPANSION, STEP_CONTRACTION, STEP_SHRINKAGE, STEP_SPECULATION
         };
 
         const size_t N; /**< Index n=DIM-1 */
@@ -132,6 +119,9 @@ namespace cppmath
         double m_exp; /**< Expansion coefficient. */
         double m_shri; /**< Shrinkage coefficient. */
 
+        bool m_speculative; /**< Indicates the speculative mode. */
+
+        void updateSum();
         void centroid();
         void accept( const ParamsT& x, double f );
 
@@ -139,6 +129,13 @@ namespace cppmath
         Step expansion();
         Step contraction();
         Step shrinkage();
+        Step speculation();
+
+        ParamsBatchT m_batch; /**< Buffer for batch evaluations. */
+        Eigen::VectorXd m_batchValues; /**< Buffer for batch evaluations. */
+
+        ParamsT m_xsum; /**< Sum of all points, updated incrementally. */
+        size_t m_updates; /**< Incremental updates of m_xsum since the last recomputation. */
 
         ParamsT m_xo;
         ParamsT m_xr;
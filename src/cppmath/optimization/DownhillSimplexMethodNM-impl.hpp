@@ -10,156 +10,103 @@
 
 namespace cppmath
 {
-    template< size_t DIM >
+    template< int DIM >
     DownhillSimplexMethodNM< DIM >::DownhillSimplexMethodNM() :
-                    DIMENSION( DIM ), VALUES( DIM + 1 )
+                    DownhillSimplexMethodNM( DIM )
     {
+        static_assert( DIM != Eigen::Dynamic, "Dimension must be passed for Eigen::Dynamic!" );
+    }
+
+    template< int DIM >
+    DownhillSimplexMethodNM< DIM >::DownhillSimplexMethodNM( size_t dimension ) :
+                    BaseT( dimension )
+    {
+        m_xo.resize( DIMENSION );
+        m_xr.resize( DIMENSION );
+        m_xsum.resize( DIMENSION );
+        m_updates = 0;
+
         m_alpha = 1.0;
         m_beta = 0.5;
         m_gamma = 2.0;
         m_maxIterations = 128;
-        m_iterations = 0;
         m_epsilon = 1e-9;
-        m_initFactor = 2.0;
         m_yr = 0.0;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     DownhillSimplexMethodNM< DIM >::~DownhillSimplexMethodNM()
     {
     }
 
-    template< size_t DIM >
-    typename DownhillSimplexMethodNM< DIM >::Converged DownhillSimplexMethodNM< DIM >::converged() const
-    {
-        if( m_iterations >= m_maxIterations )
-        {
-            return CONVERGED_ITERATIONS;
-        }
-        if( func( m_x[0] ) <= m_epsilon )
-        {
-            return CONVERGED_EPSILON;
-        }
-        return CONVERGED_NO;
-    }
-
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethodNM< DIM >::getReflectionCoeff() const
     {
         return m_alpha;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethodNM< DIM >::setReflectionCoeff( double alpha )
     {
         assert( 0.0 <= alpha );
         m_alpha = alpha;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethodNM< DIM >::getContractionCoeff() const
     {
         return m_beta;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethodNM< DIM >::setContractionCoeff( double beta )
     {
         assert( 0.0 <= beta && beta <= 1.0 );
         m_beta = beta;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     double DownhillSimplexMethodNM< DIM >::getExpansionCoeff() const
     {
         return m_gamma;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethodNM< DIM >::setExpansionCoeff( double gamma )
     {
         m_gamma = gamma;
     }
 
-    template< size_t DIM >
-    size_t DownhillSimplexMethodNM< DIM >::getMaximumIterations() const
-    {
-        return m_maxIterations;
-    }
-
-    template< size_t DIM >
-    void DownhillSimplexMethodNM< DIM >::setMaximumIterations( size_t iterations )
-    {
-        m_maxIterations = iterations;
-    }
-
-    template< size_t DIM >
-    double DownhillSimplexMethodNM< DIM >::getEpsilon() const
-    {
-        return m_epsilon;
-    }
-
-    template< size_t DIM >
-    void DownhillSimplexMethodNM< DIM >::setEpsilon( double eps )
-    {
-        m_epsilon = eps;
-    }
-
-    template< size_t DIM >
-    double DownhillSimplexMethodNM< DIM >::getInitialFactor() const
-    {
-        return m_initFactor;
-    }
-
-    template< size_t DIM >
-    void DownhillSimplexMethodNM< DIM >::setInitialFactor( double factor )
-    {
-        m_initFactor = factor;
-    }
-
-    template< size_t DIM >
-    size_t DownhillSimplexMethodNM< DIM >::getResultIterations() const
-    {
-        return m_iterations;
-    }
-
-    template< size_t DIM >
-    typename DownhillSimplexMethodNM< DIM >::ParamsT DownhillSimplexMethodNM< DIM >::getResultParams() const
-    {
-        return m_x[0];
-    }
-
-    template< size_t DIM >
-    double DownhillSimplexMethodNM< DIM >::getResultError() const
-    {
-        return m_y[0];
-    }
-
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethodNM< DIM >::createInitials( const ParamsT& initial )
     {
-        m_x[0] = initial;
+        m_batch.resize( DIMENSION, VALUES );
+        m_batch.col( 0 ) = initial;
         typename ParamsT::Index dim = 0;
         for( size_t i = 1; i < VALUES; ++i )
         {
-            ParamsT p = initial;
-            p( dim ) = p( dim ) * m_initFactor;
-            m_x[i] = p;
+            m_batch.col( i ) = initial;
+            m_batch( dim, i ) = initial( dim ) * m_initFactor;
             ++dim;
         }
 
-        for( size_t i = 0; i < VALUES; ++i )
-        {
-            m_y[i] = func( m_x[i] );
-        }
+        evaluateBatch( &m_batchValues, m_batch );
+        m_x = m_batch;
+        m_f = m_batchValues;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethodNM< DIM >::optimize( const ParamsT& initial )
     {
         // Prepare optimization
-        m_iterations = 0;
+        start();
         createInitials( initial );
+        for( size_t i = 0; i < VALUES; ++i )
+        {
+            m_idx( i ) = i;
+        }
+        order();
+        updateSum();
 
         Step next = STEP_START;
         while( next != STEP_EXIT )
@@ -167,8 +114,8 @@ namespace cppmath
             switch( next )
             {
                 case STEP_START:
-                    order();
-                    if( converged() != CONVERGED_NO )
+                    m_statistics.addBest( m_f( m_idx( 0 ) ) );
+                    if( converged() != BaseT::CONVERGED_NO )
                     {
                         next = STEP_EXIT;
                         break;
@@ -192,112 +139,120 @@ namespace cppmath
                     break;
             }
         }
+        m_statistics.stop();
     }
 
-    template< size_t DIM >
-    void DownhillSimplexMethodNM< DIM >::order()
+    template< int DIM >
+    void DownhillSimplexMethodNM< DIM >::updateSum()
     {
-        // The ordering is used in reflection() and for min/max.
-        // Insertionsort
-        for( size_t i = 1; i < VALUES; ++i )
-        {
-            const ParamsT x_insert = m_x[i];
-            const double y_insert = m_y[i];
-            size_t j = i;
-            while( j > 0 && m_y[j - 1] > y_insert )
-            {
-                m_x[j] = m_x[j - 1];
-                m_y[j] = m_y[j - 1];
-                --j;
-            }
-            m_x[j] = x_insert;
-            m_y[j] = y_insert;
-        }
+        m_xsum = m_x.rowwise().sum();
+        m_updates = 0;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     void DownhillSimplexMethodNM< DIM >::centroid()
     {
-        ParamsT xo = ParamsT::Zero();
-        for( size_t i = 0; i < DIM; ++i )
+        // Centroid of all points except the worst one, the sum of all points is updated incrementally.
+        m_xo = ( m_xsum - m_x.col( m_idx( DIMENSION ) ) ) / static_cast< double >( DIMENSION );
+    }
+
+    template< int DIM >
+    void DownhillSimplexMethodNM< DIM >::accept( const ParamsT& x, double y )
+    {
+        const int worst = m_idx( DIMENSION );
+        m_xsum += x - m_x.col( worst );
+        m_x.col( worst ) = x;
+        m_f( worst ) = y;
+        orderWorst();
+
+        // Recompute the sum from time to time to avoid an accumulation of rounding errors.
+        if( ++m_updates >= VALUES )
         {
-            xo += m_x[i];
+            updateSum();
         }
-        m_xo = xo / DIM;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethodNM< DIM >::Step DownhillSimplexMethodNM< DIM >::reflection()
     {
-        m_xr = m_xo + m_alpha * ( m_xo - m_x[DIM] );
-        m_yr = func( m_xr );
+        m_xr = m_xo + m_alpha * ( m_xo - m_x.col( m_idx( DIMENSION ) ) );
+        m_yr = evaluate( m_xr );
         const double yr = m_yr;
-        const double yl = m_y[0];
+        const double yl = m_f( m_idx( 0 ) );
 
         if( yr < yl )
         {
             return STEP_EXPANSION;
         }
         // was sorted so
-        const double yi = m_y[DIM - 1];
+        const double yi = m_f( m_idx( DIMENSION - 1 ) );
         if( yr > yi )
         {
-            const double yh = m_y[DIM];
+            const double yh = m_f( m_idx( DIMENSION ) );
             if( yr <= yh )
             {
-                m_x[DIM] = m_xr;
-                m_y[DIM] = yr;
+                accept( m_xr, yr );
             }
             return STEP_CONTRACTION;
         }
         else
         {
-            m_x[DIM] = m_xr;
-            m_y[DIM] = yr;
+            accept( m_xr, yr );
+            m_statistics.addStep( SimplexStatistics::STEP_REFLECTION );
             return STEP_START;
         }
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethodNM< DIM >::Step DownhillSimplexMethodNM< DIM >::expansion()
     {
         const ParamsT xe = m_xo + m_gamma * ( m_xr - m_xo );
-        const double ye = func( xe );
-        const double yl = m_y[0];
+        const double ye = evaluate( xe );
+        const double yl = m_f( m_idx( 0 ) );
 
         if( ye < yl )
         {
-            m_x[DIM] = xe;
-            m_y[DIM] = ye;
+            accept( xe, ye );
         }
         else
         {
-            m_x[DIM] = m_xr;
-            m_y[DIM] = m_yr;
+            accept( m_xr, m_yr );
         }
+        m_statistics.addStep( SimplexStatistics::STEP_EXPANSION );
         return STEP_START;
     }
 
-    template< size_t DIM >
+    template< int DIM >
     typename DownhillSimplexMethodNM< DIM >::Step DownhillSimplexMethodNM< DIM >::contraction()
     {
-        const ParamsT xc = m_xo + m_beta * ( m_x[DIM] - m_xo );
-        const double yc = func( xc );
-        const double yh = m_y[DIM];
+        const ParamsT xc = m_xo + m_beta * ( m_x.col( m_idx( DIMENSION ) ) - m_xo );
+        const double yc = evaluate( xc );
+        const double yh = m_f( m_idx( DIMENSION ) );
 
         if( yc > yh )
         {
-            const ParamsT xl = m_x[0];
-            for( size_t i = 0; i < DIM + 1; ++i )
+            // x_l is not moved, so only DIM new points must be evaluated.
+            const ParamsT xl = m_x.col( m_idx( 0 ) );
+            m_batch.resize( DIMENSION, DIMENSION );
+            for( size_t i = 1; i < VALUES; ++i )
+            {
+                m_batch.col( i - 1 ) = 0.5 * ( m_x.col( m_idx( i ) ) + xl );
+            }
+
+            evaluateBatch( &m_batchValues, m_batch );
+            for( size_t i = 1; i < VALUES; ++i )
             {
-                m_x[i] = 0.5 * ( m_x[i] + xl );
-                m_y[i] = func( m_x[i] );
+                m_x.col( m_idx( i ) ) = m_batch.col( i - 1 );
+                m_f( m_idx( i ) ) = m_batchValues( i - 1 );
             }
+            order();
+            updateSum();
+            m_statistics.addStep( SimplexStatistics::STEP_SHRINKAGE );
         }
         else
         {
-            m_x[DIM] = xc;
-            m_y[DIM] = yc;
+            accept( xc, yc );
+            m_statistics.addStep( SimplexStatistics::STEP_CONTRACTION );
         }
         return STEP_START;
     }
@@ -5,49 +5,48 @@
 
 #include <Eigen/Dense>
 
+#include "DownhillSimplexBase.hpp"
+
 namespace cppmath
 {
     /**
      * Implementation of the original Downhill Simplex or Nelder-Mead method for nonlinear optimization from 1965.
      * J. Nelder, R. Mead, "A Simplex Method for Function Minimization," Computer Journal, 1965, 7, 308-313
      *
+     * DIM can be Eigen::Dynamic to choose the dimension at runtime, see constructor. Fixed dimensions keep all data on
+     * the stack. The simplex is stored as a contiguous column-major matrix in both cases.
+     *
      * \author cpieloth
      * \copyright Copyright 2014 Christof Pieloth, Licensed under the Apache License, Version 2.0
      */
-    template< size_t DIM >
-    class DownhillSimplexMethodNM
+    template< int DIM >
+    class DownhillSimplexMethodNM: public DownhillSimplexBase< DIM >
     {
     public:
-        typedef Eigen::Matrix< double, DIM, 1 > ParamsT; /**< Abbreviation for a vector of parameters. */
+        typedef DownhillSimplexBase< DIM > BaseT; /**< Abbreviation for the base class. */
+        typedef typename BaseT::ParamsT ParamsT; /**< Abbreviation for a vector of parameters. */
+        typedef typename BaseT::ParamsBatchT ParamsBatchT; /**< Parameter vectors as columns. */
+        typedef typename BaseT::Converged Converged; /**< Enum to indicate how the optimization was converged. */
 
         /**
-         * Enum to indicate how the optimization was converged.
+         * Constructor for a fixed dimension DIM.
          */
-        enum Converged
-        {
-            CONVERGED_NO, /**< Optimization was not started. */
-            CONVERGED_EPSILON, /**< Optimization is smaller than epsilon/threshold. */
-            CONVERGED_ITERATIONS, /**< Maximum iterations was reached. */
-            CONVERGED_YES /**< Optimization is converged, but not specified how. */
-        };
-
         DownhillSimplexMethodNM();
-        virtual ~DownhillSimplexMethodNM();
 
         /**
-         * Implementation of the function to minimize.
+         * Constructor for a dimension given at runtime, e.g. for DIM = Eigen::Dynamic.
          *
-         * \param x  n-dimensional parameter vector.
-         * \return function value for vector x.
+         * \param dimension Dimension of the parameter vector, must be equal to DIM for a fixed dimension.
          */
-        virtual double func( const ParamsT& x ) const = 0;
+        explicit DownhillSimplexMethodNM( size_t dimension );
+        virtual ~DownhillSimplexMethodNM();
 
         /**
          * Indicates how the optimization was converged.
          *
          * \return Enum::Converged
          */
-        virtual Converged converged() const;
+        using BaseT::converged;
 
         double getReflectionCoeff() const;
 
@@ -61,24 +60,6 @@ namespace cppmath
 
         void setExpansionCoeff( double gamma );
 
-        size_t getMaximumIterations() const;
-
-        void setMaximumIterations( size_t iterations );
-
-        double getEpsilon() const;
-
-        void setEpsilon( double eps );
-
-        double getInitialFactor() const;
-
-        void setInitialFactor( double factor );
-
-        size_t getResultIterations() const;
-
-        ParamsT getResultParams() const;
-
-        double getResultError() const;
-
         /**
          * Starts the optimization.
          *
@@ -87,28 +68,32 @@ namespace cppmath
         void optimize( const ParamsT& initial );
 
     protected:
-        /**
-         * Orders the parameters x and f(x) from min to max.
-         */
-        virtual void order();
-
         /**
          * Creates the initial parameter set and their function values.
          *
          * \param initial Start parameter used to calculate initials.
          */
         virtual void createInitials( const ParamsT& initial );
-        double m_initFactor; /**< Factor to create the initial parameter set. */
-
-        ParamsT m_x[DIM + 1]; /**< Vector of all n+1 points. */
-        double m_y[DIM + 1]; /**< Stores the function values to reduce re-calculation. */
 
-        double m_epsilon; /**< Threshold or deviation for convergence. */
-        size_t m_maxIterations; /**< Maximum iterations until the algorithm is canceled. */
-        size_t m_iterations; /**< Iteration counter used for break condition. */
+        using BaseT::order;
+        using BaseT::orderWorst;
+        using BaseT::start;
+        using BaseT::evaluate;
+        using BaseT::evaluateBatch;
+
+        using BaseT::m_initFactor;
+        using BaseT::m_x;
+        using BaseT::m_f;
+        using BaseT::m_idx;
+        using BaseT::m_maxIterations;
+        using BaseT::m_iterations;
+        using BaseT::m_epsilon;
+        using BaseT::m_statistics;
+        using BaseT::DIMENSION;
+        using BaseT::VALUES;
 
-        const size_t DIMENSION; /**< Constant for dimension. */
-        const size_t VALUES; /**< Constant for DIM+1. */
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
     private:
         enum Step
@@ -120,11 +105,19 @@ namespace cppmath
         double m_beta; /**< Contraction coefficient. */
         double m_gamma; /**< Expansion coefficient. */
 
+        void updateSum();
         void centroid();
+        void accept( const ParamsT& x, double y );
         Step reflection();
         Step expansion();
         Step contraction();
 
+        ParamsBatchT m_batch; /**< Buffer for batch evaluations. */
+        Eigen::VectorXd m_batchValues; /**< Buffer for batch evaluations. */
+
+        ParamsT m_xsum; /**< Sum of all points, updated incrementally. */
+        size_t m_updates; /**< Incremental updates of m_xsum since the last recomputation. */
+
         ParamsT m_xo;
         ParamsT m_xr;
         double m_yr;
@@ -0,0 +1,106 @@
+#ifndef CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMULTISTART_IMPL_HPP_
+#define CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMULTISTART_IMPL_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include "DownhillSimplexMultiStart.hpp"
+
+namespace cppmath
+{
+    template< typename OPT >
+    DownhillSimplexMultiStart< OPT >::DownhillSimplexMultiStart( const OPT& prototype ) :
+                    m_prototype( prototype ), m_pool( NULL ), m_best( 0 )
+    {
+    }
+
+    template< typename OPT >
+    DownhillSimplexMultiStart< OPT >::~DownhillSimplexMultiStart()
+    {
+    }
+
+    template< typename OPT >
+    void DownhillSimplexMultiStart< OPT >::setThreadPool( ThreadPool* const pool )
+    {
+        m_pool = pool;
+    }
+
+    template< typename OPT >
+    void DownhillSimplexMultiStart< OPT >::optimize( const ParamsListT& initials )
+    {
+        if( m_pool != NULL )
+        {
+            run( initials, m_pool );
+        }
+        else
+        {
+            ThreadPool pool;
+            run( initials, &pool );
+        }
+    }
+
+    template< typename OPT >
+    void DownhillSimplexMultiStart< OPT >::run( const ParamsListT& initials, ThreadPool* const pool )
+    {
+        m_results.clear();
+        m_results.resize( initials.size() );
+        m_best = 0;
+
+        // Each thread copies the prototype once and fetches the next start, when it has finished its previous start.
+        // So slow converging starts do not stall the other threads.
+        std::atomic< size_t > next( 0 );
+        const std::function< void( size_t ) > worker = [&]( size_t )
+        {
+            OPT opt( m_prototype );
+            for( size_t i = next++; i < initials.size(); i = next++ )
+            {
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                opt.optimize( initials[i] );
+                const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+                StartResult& result = m_results[i];
+                result.initial = initials[i];
+                result.params = opt.getResultParams();
+                result.error = opt.getResultError();
+                result.iterations = opt.getResultIterations();
+                result.seconds = std::chrono::duration< double >( stop - start ).count();
+            }
+        };
+        pool->parallelFor( pool->getThreadCount(), worker );
+
+        for( size_t i = 1; i < m_results.size(); ++i )
+        {
+            if( m_results[i].error < m_results[m_best].error )
+            {
+                m_best = i;
+            }
+        }
+    }
+
+    template< typename OPT >
+    size_t DownhillSimplexMultiStart< OPT >::getResultIndex() const
+    {
+        return m_best;
+    }
+
+    template< typename OPT >
+    typename DownhillSimplexMultiStart< OPT >::ParamsT DownhillSimplexMultiStart< OPT >::getResultParams() const
+    {
+        return m_results.at( m_best ).params;
+    }
+
+    template< typename OPT >
+    double DownhillSimplexMultiStart< OPT >::getResultError() const
+    {
+        return m_results.at( m_best ).error;
+    }
+
+    template< typename OPT >
+    const typename DownhillSimplexMultiStart< OPT >::ResultListT& DownhillSimplexMultiStart< OPT >::getResults() const
+    {
+        return m_results;
+    }
+} /* namespace cppmath */
+
+#endif  // CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMULTISTART_IMPL_HPP_
@@ -0,0 +1,101 @@
+#ifndef CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMULTISTART_HPP_
+#define CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMULTISTART_HPP_
+
+#include <cstddef> // size_t
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include "../concurrent/ThreadPool.hpp"
+
+namespace cppmath
+{
+    /**
+     * Runs a Downhill Simplex optimization from many initial points in parallel to escape local minima.
+     * Each thread works on its own copy of the prototype, so OPT::func() is used unchanged.
+     * OPT can be any subclass of DownhillSimplexMethod or DownhillSimplexMethodNM.
+     *
+     * \author cpieloth
+     * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+     */
+    template< typename OPT >
+    class DownhillSimplexMultiStart
+    {
+    public:
+        typedef typename OPT::ParamsT ParamsT; /**< Abbreviation for a vector of parameters. */
+        typedef std::vector< ParamsT, Eigen::aligned_allocator< ParamsT > > ParamsListT; /**< List of parameters. */
+
+        /**
+         * Result and statistics of a single start.
+         */
+        struct StartResult
+        {
+            ParamsT initial; /**< Initial start point. */
+            ParamsT params; /**< Result of the optimization. */
+            double error; /**< Function value of the result. */
+            size_t iterations; /**< Iterations needed by the optimization. */
+            double seconds; /**< Wall time of the optimization. */
+
+            EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        };
+
+        typedef std::vector< StartResult, Eigen::aligned_allocator< StartResult > > ResultListT; /**< List of results. */
+
+        /**
+         * Constructor.
+         *
+         * \param prototype Configured optimizer, which is copied for each thread.
+         */
+        explicit DownhillSimplexMultiStart( const OPT& prototype );
+
+        virtual ~DownhillSimplexMultiStart();
+
+        /**
+         * Sets the thread pool to use. If no pool is set, a temporary pool is created for each optimize() call.
+         *
+         * \param pool Thread pool, must exist during optimize().
+         */
+        void setThreadPool( ThreadPool* const pool );
+
+        /**
+         * Starts an independent optimization for each initial point.
+         *
+         * \param initials Initial start points.
+         */
+        void optimize( const ParamsListT& initials );
+
+        /**
+         * Returns the index of the best start.
+         *
+         * \return Index of the start with the smallest function value.
+         */
+        size_t getResultIndex() const;
+
+        ParamsT getResultParams() const;
+
+        double getResultError() const;
+
+        /**
+         * Returns the results and statistics of all starts in order of the initial points.
+         *
+         * \return List of results.
+         */
+        const ResultListT& getResults() const;
+
+    private:
+        void run( const ParamsListT& initials, ThreadPool* const pool );
+
+        const OPT m_prototype; /**< Configured optimizer to copy from. */
+
+        ThreadPool* m_pool; /**< Optional pool to use. */
+
+        ResultListT m_results; /**< Results of the last optimization. */
+        size_t m_best; /**< Index of the best result. */
+    };
+} /* namespace cppmath */
+
+// Load the implementation
+#include "DownhillSimplexMultiStart-impl.hpp"
+
+#endif  // CPPMATH_OPTIMIZATION_DOWNHILLSIMPLEXMULTISTART_HPP_
@@ -0,0 +1,143 @@
+#ifndef CPPMATH_OPTIMIZATION_EVALUATIONCACHE_IMPL_HPP_
+#define CPPMATH_OPTIMIZATION_EVALUATIONCACHE_IMPL_HPP_
+
+#include "EvaluationCache.hpp"
+
+namespace cppmath
+{
+    inline EvaluationCache::EvaluationCache( size_t capacity ) :
+                    m_capacity( capacity ), m_hits( 0 ), m_misses( 0 )
+    {
+    }
+
+    inline EvaluationCache::EvaluationCache( const EvaluationCache& other ) :
+                    m_capacity( other.m_capacity ), m_hits( other.m_hits ), m_misses( other.m_misses ),
+                    m_entries( other.m_entries )
+    {
+        rebuildMap();
+    }
+
+    inline EvaluationCache::~EvaluationCache()
+    {
+    }
+
+    inline EvaluationCache& EvaluationCache::operator=( const EvaluationCache& other )
+    {
+        if( this != &other )
+        {
+            m_capacity = other.m_capacity;
+            m_hits = other.m_hits;
+            m_misses = other.m_misses;
+            m_entries = other.m_entries;
+            rebuildMap();
+        }
+        return *this;
+    }
+
+    inline size_t EvaluationCache::getCapacity() const
+    {
+        return m_capacity;
+    }
+
+    inline void EvaluationCache::setCapacity( size_t capacity )
+    {
+        m_capacity = capacity;
+        evict();
+    }
+
+    inline bool EvaluationCache::isEnabled() const
+    {
+        return m_capacity > 0;
+    }
+
+    inline size_t EvaluationCache::getSize() const
+    {
+        return m_map.size();
+    }
+
+    inline size_t EvaluationCache::getHits() const
+    {
+        return m_hits;
+    }
+
+    inline size_t EvaluationCache::getMisses() const
+    {
+        return m_misses;
+    }
+
+    inline void EvaluationCache::clear()
+    {
+        m_entries.clear();
+        m_map.clear();
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    inline bool EvaluationCache::lookup( double* const value, const double* const x, size_t n )
+    {
+        if( m_capacity == 0 )
+        {
+            return false;
+        }
+
+        const EntryMapT::iterator it = m_map.find( key( x, n ) );
+        if( it == m_map.end() )
+        {
+            ++m_misses;
+            return false;
+        }
+
+        ++m_hits;
+        m_entries.splice( m_entries.begin(), m_entries, it->second );
+        *value = it->second->second;
+        return true;
+    }
+
+    inline void EvaluationCache::insert( const double* const x, size_t n, double value )
+    {
+        if( m_capacity == 0 )
+        {
+            return;
+        }
+
+        const std::string k = key( x, n );
+        const EntryMapT::iterator it = m_map.find( k );
+        if( it != m_map.end() )
+        {
+            it->second->second = value;
+            m_entries.splice( m_entries.begin(), m_entries, it->second );
+            return;
+        }
+
+        m_entries.push_front( std::make_pair( k, value ) );
+        m_map[k] = m_entries.begin();
+        evict();
+    }
+
+    inline std::string EvaluationCache::key( const double* const x, size_t n )
+    {
+        return std::string( reinterpret_cast< const char* >( x ), n * sizeof(double) );
+    }
+
+    inline void EvaluationCache::evict()
+    {
+        while( m_map.size() > m_capacity )
+        {
+            m_map.erase( m_entries.back().first );
+            m_entries.pop_back();
+        }
+    }
+
+    inline void EvaluationCache::rebuildMap()
+    {
+        // Iterators of other's map point into other's list, so they must not be copied.
+        m_map.clear();
+        m_map.reserve( m_entries.size() );
+        for( EntryListT::iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+        {
+            m_map[it->first] = it;
+        }
+    }
+} /* namespace cppmath */
+
+#endif  // CPPMATH_OPTIMIZATION_EVALUATIONCACHE_IMPL_HPP_
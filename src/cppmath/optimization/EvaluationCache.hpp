@@ -0,0 +1,111 @@
+#ifndef CPPMATH_OPTIMIZATION_EVALUATIONCACHE_HPP_
+#define CPPMATH_OPTIMIZATION_EVALUATIONCACHE_HPP_
+
+#include <cstddef> // size_t
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility> // pair
+
+namespace cppmath
+{
+    /**
+     * Bounded LRU cache for function values, to not evaluate an expensive function twice for the same parameters.
+     * The key is the exact bit pattern of the parameter vector. The cache is not thread-safe.
+     *
+     * \author cpieloth
+     * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+     */
+    class EvaluationCache
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * \param capacity Maximum number of entries, 0 disables the cache (default).
+         */
+        explicit EvaluationCache( size_t capacity = 0 );
+
+        /**
+         * Copies the entries and counters. The index is rebuilt for the copied entries.
+         *
+         * \param other Cache to copy.
+         */
+        EvaluationCache( const EvaluationCache& other );
+
+        virtual ~EvaluationCache();
+
+        EvaluationCache& operator=( const EvaluationCache& other );
+
+        size_t getCapacity() const;
+
+        /**
+         * Sets the maximum number of entries. Least recently used entries are removed, if the capacity is reduced.
+         *
+         * \param capacity Maximum number of entries, 0 disables the cache.
+         */
+        void setCapacity( size_t capacity );
+
+        bool isEnabled() const;
+
+        /**
+         * Returns the current number of entries.
+         *
+         * \return Number of entries.
+         */
+        size_t getSize() const;
+
+        size_t getHits() const;
+
+        size_t getMisses() const;
+
+        /**
+         * Removes all entries and resets the hit and miss counters.
+         */
+        void clear();
+
+        /**
+         * Searches the function value for a parameter vector and counts a hit or miss.
+         *
+         * \param value Stores the function value, if found.
+         * \param x Data of the parameter vector.
+         * \param n Size of the parameter vector.
+         * \return True, if the function value was found.
+         */
+        bool lookup( double* const value, const double* const x, size_t n );
+
+        /**
+         * Inserts a function value. If the cache is full, the least recently used entry is removed.
+         *
+         * \param x Data of the parameter vector.
+         * \param n Size of the parameter vector.
+         * \param value Function value for x.
+         */
+        void insert( const double* const x, size_t n, double value );
+
+    private:
+        typedef std::list< std::pair< std::string, double > > EntryListT;
+        typedef std::unordered_map< std::string, EntryListT::iterator > EntryMapT;
+
+        static std::string key( const double* const x, size_t n );
+
+        void evict();
+
+        /**
+         * Rebuilds the index for the current entries.
+         */
+        void rebuildMap();
+
+        size_t m_capacity;
+        size_t m_hits;
+        size_t m_misses;
+
+        EntryListT m_entries; /**< Entries from most to least recently used. */
+        EntryMapT m_map; /**< Key to entry. */
+    };
+} /* namespace cppmath */
+
+// Load the implementation
+#include "EvaluationCache-impl.hpp"
+
+#endif  // CPPMATH_OPTIMIZATION_EVALUATIONCACHE_HPP_
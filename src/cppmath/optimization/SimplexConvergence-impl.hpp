@@ -0,0 +1,114 @@
+#ifndef CPPMATH_OPTIMIZATION_SIMPLEXCONVERGENCE_IMPL_HPP_
+#define CPPMATH_OPTIMIZATION_SIMPLEXCONVERGENCE_IMPL_HPP_
+
+#include <cmath> // fabs()
+
+#include "SimplexConvergence.hpp"
+
+namespace cppmath
+{
+    inline SimplexConvergence::SimplexConvergence() :
+                    m_spread( -1.0 ), m_diameter( -1.0 ), m_relative( -1.0 ), m_seconds( -1.0 ), m_evaluations( 0 ),
+                                    m_start( std::chrono::steady_clock::now() )
+    {
+    }
+
+    inline SimplexConvergence::~SimplexConvergence()
+    {
+    }
+
+    inline double SimplexConvergence::getFunctionSpread() const
+    {
+        return m_spread;
+    }
+
+    inline void SimplexConvergence::setFunctionSpread( double spread )
+    {
+        m_spread = spread;
+    }
+
+    inline double SimplexConvergence::getDiameter() const
+    {
+        return m_diameter;
+    }
+
+    inline void SimplexConvergence::setDiameter( double diameter )
+    {
+        m_diameter = diameter;
+    }
+
+    inline double SimplexConvergence::getRelativeTolerance() const
+    {
+        return m_relative;
+    }
+
+    inline void SimplexConvergence::setRelativeTolerance( double tolerance )
+    {
+        m_relative = tolerance;
+    }
+
+    inline double SimplexConvergence::getTimeBudget() const
+    {
+        return m_seconds;
+    }
+
+    inline void SimplexConvergence::setTimeBudget( double seconds )
+    {
+        m_seconds = seconds;
+    }
+
+    inline size_t SimplexConvergence::getEvaluationBudget() const
+    {
+        return m_evaluations;
+    }
+
+    inline void SimplexConvergence::setEvaluationBudget( size_t evaluations )
+    {
+        m_evaluations = evaluations;
+    }
+
+    inline void SimplexConvergence::start()
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    inline double SimplexConvergence::getElapsedSeconds() const
+    {
+        return std::chrono::duration< double >( std::chrono::steady_clock::now() - m_start ).count();
+    }
+
+    template< typename SimplexT, typename ValuesT, typename IndicesT >
+    SimplexConvergence::Criterion SimplexConvergence::check( const SimplexT& x, const ValuesT& f, const IndicesT& idx,
+                    size_t evaluations ) const
+    {
+        const double f_1 = f( idx( 0 ) );
+        const double spread = f( idx( idx.size() - 1 ) ) - f_1;
+        if( m_spread >= 0.0 && spread <= m_spread )
+        {
+            return CRITERION_SPREAD;
+        }
+        if( m_relative >= 0.0 && spread <= m_relative * std::fabs( f_1 ) )
+        {
+            return CRITERION_RELATIVE;
+        }
+        if( m_diameter >= 0.0 )
+        {
+            const double diameter = ( x.colwise() - x.col( idx( 0 ) ) ).cwiseAbs().maxCoeff();
+            if( diameter <= m_diameter )
+            {
+                return CRITERION_DIAMETER;
+            }
+        }
+        if( m_evaluations > 0 && evaluations >= m_evaluations )
+        {
+            return CRITERION_EVALUATIONS;
+        }
+        if( m_seconds >= 0.0 && getElapsedSeconds() >= m_seconds )
+        {
+            return CRITERION_TIME;
+        }
+        return CRITERION_NONE;
+    }
+} /* namespace cppmath */
+
+#endif  // CPPMATH_OPTIMIZATION_SIMPLEXCONVERGENCE_IMPL_HPP_
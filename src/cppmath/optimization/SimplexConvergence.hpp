@@ -0,0 +1,120 @@
+#ifndef CPPMATH_OPTIMIZATION_SIMPLEXCONVERGENCE_HPP_
+#define CPPMATH_OPTIMIZATION_SIMPLEXCONVERGENCE_HPP_
+
+#include <chrono>
+#include <cstddef> // size_t
+
+namespace cppmath
+{
+    /**
+     * Optional convergence criteria for the Downhill Simplex methods, which are checked in addition to the maximum
+     * iterations and epsilon. All criteria are disabled by default. For custom criteria, converged() of the optimizer
+     * can be overridden.
+     *
+     * \author cpieloth
+     * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+     */
+    class SimplexConvergence
+    {
+    public:
+        /**
+         * Enum to indicate which criterion was fulfilled.
+         */
+        enum Criterion
+        {
+            CRITERION_NONE, /**< No criterion is fulfilled. */
+            CRITERION_SPREAD, /**< f(x_n+1) - f(x_1) is smaller than the function spread. */
+            CRITERION_DIAMETER, /**< Maximum distance (infinity norm) of all points to x_1 is smaller than the diameter. */
+            CRITERION_RELATIVE, /**< f(x_n+1) - f(x_1) is smaller than the relative tolerance of |f(x_1)|. */
+            CRITERION_TIME, /**< Time budget is exceeded. */
+            CRITERION_EVALUATIONS /**< Evaluation budget is exceeded. */
+        };
+
+        SimplexConvergence();
+        virtual ~SimplexConvergence();
+
+        double getFunctionSpread() const;
+
+        /**
+         * Sets the threshold for the spread of the function values across the simplex.
+         *
+         * \param spread Threshold, a negative value disables the criterion.
+         */
+        void setFunctionSpread( double spread );
+
+        double getDiameter() const;
+
+        /**
+         * Sets the threshold for the simplex diameter, i.e. the maximum distance of all points to the best point.
+         *
+         * \param diameter Threshold, a negative value disables the criterion.
+         */
+        void setDiameter( double diameter );
+
+        double getRelativeTolerance() const;
+
+        /**
+         * Sets the threshold for the spread of the function values relative to the best function value.
+         *
+         * \param tolerance Relative threshold, a negative value disables the criterion.
+         */
+        void setRelativeTolerance( double tolerance );
+
+        double getTimeBudget() const;
+
+        /**
+         * Sets the wall-clock budget for an optimization.
+         *
+         * \param seconds Budget in seconds, a negative value disables the criterion.
+         */
+        void setTimeBudget( double seconds );
+
+        size_t getEvaluationBudget() const;
+
+        /**
+         * Sets the budget of function evaluations for an optimization.
+         * The budget can be exceeded by the evaluations of the last iteration.
+         *
+         * \param evaluations Maximum evaluations, 0 disables the criterion.
+         */
+        void setEvaluationBudget( size_t evaluations );
+
+        /**
+         * Starts the clock for the time budget. Is called at the start of an optimization.
+         */
+        void start();
+
+        /**
+         * Returns the seconds since start().
+         *
+         * \return Elapsed seconds.
+         */
+        double getElapsedSeconds() const;
+
+        /**
+         * Checks all enabled criteria.
+         *
+         * \param x All points as columns.
+         * \param f Function values of the columns.
+         * \param idx Column indices ordered by f(x) from min to max.
+         * \param evaluations Function evaluations so far.
+         * \return The first fulfilled criterion or CRITERION_NONE.
+         */
+        template< typename SimplexT, typename ValuesT, typename IndicesT >
+        Criterion check( const SimplexT& x, const ValuesT& f, const IndicesT& idx, size_t evaluations ) const;
+
+    private:
+        double m_spread;
+        double m_diameter;
+        double m_relative;
+        double m_seconds;
+        size_t m_evaluations;
+
+        std::chrono::steady_clock::time_point m_start;
+    };
+} /* namespace cppmath */
+
+// Load the implementation
+#include "SimplexConvergence-impl.hpp"
+
+#endif  // CPPMATH_OPTIMIZATION_SIMPLEXCONVERGENCE_HPP_
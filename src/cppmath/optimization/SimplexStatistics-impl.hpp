@@ -0,0 +1,105 @@
+#ifndef CPPMATH_OPTIMIZATION_SIMPLEXSTATISTICS_IMPL_HPP_
+#define CPPMATH_OPTIMIZATION_SIMPLEXSTATISTICS_IMPL_HPP_
+
+#include "SimplexStatistics.hpp"
+
+namespace cppmath
+{
+    inline SimplexStatistics::SimplexStatistics() :
+                    m_evaluations( 0 ), m_objectiveSeconds( 0.0 ), m_totalSeconds( 0.0 )
+    {
+        for( size_t i = 0; i < STEP_COUNT; ++i )
+        {
+            m_steps[i] = 0;
+        }
+    }
+
+    inline SimplexStatistics::~SimplexStatistics()
+    {
+    }
+
+    inline SimplexStatistics::TimePointT SimplexStatistics::now()
+    {
+#ifdef CPPMATH_NO_STATISTICS
+        return TimePointT();
+#else
+        return std::chrono::steady_clock::now();
+#endif
+    }
+
+    inline void SimplexStatistics::start()
+    {
+#ifndef CPPMATH_NO_STATISTICS
+        m_evaluations = 0;
+        for( size_t i = 0; i < STEP_COUNT; ++i )
+        {
+            m_steps[i] = 0;
+        }
+        m_objectiveSeconds = 0.0;
+        m_totalSeconds = 0.0;
+        m_trajectory.clear();
+        m_start = now();
+#endif
+    }
+
+    inline void SimplexStatistics::stop()
+    {
+#ifndef CPPMATH_NO_STATISTICS
+        m_totalSeconds = std::chrono::duration< double >( now() - m_start ).count();
+#endif
+    }
+
+    inline void SimplexStatistics::addEvaluations( size_t evaluations, const TimePointT& start )
+    {
+#ifndef CPPMATH_NO_STATISTICS
+        m_evaluations += evaluations;
+        m_objectiveSeconds += std::chrono::duration< double >( now() - start ).count();
+#endif
+    }
+
+    inline void SimplexStatistics::addStep( Step step )
+    {
+#ifndef CPPMATH_NO_STATISTICS
+        ++m_steps[step];
+#endif
+    }
+
+    inline void SimplexStatistics::addBest( double f )
+    {
+#ifndef CPPMATH_NO_STATISTICS
+        m_trajectory.push_back( f );
+#endif
+    }
+
+    inline size_t SimplexStatistics::getEvaluations() const
+    {
+        return m_evaluations;
+    }
+
+    inline size_t SimplexStatistics::getSteps( Step step ) const
+    {
+        return m_steps[step];
+    }
+
+    inline double SimplexStatistics::getObjectiveSeconds() const
+    {
+        return m_objectiveSeconds;
+    }
+
+    inline double SimplexStatistics::getTotalSeconds() const
+    {
+        return m_totalSeconds;
+    }
+
+    inline double SimplexStatistics::getOverheadSeconds() const
+    {
+        return m_totalSeconds - m_objectiveSeconds;
+    }
+
+    inline const std::vector< double >& SimplexStatistics::getTrajectory() const
+    {
+        return m_trajectory;
+    }
+} /* namespace cppmath */
+
+#endif  // CPPMATH_OPTIMIZATION_SIMPLEXSTATISTICS_IMPL_HPP_
@@ -0,0 +1,131 @@
+#ifndef CPPMATH_OPTIMIZATION_SIMPLEXSTATISTICS_HPP_
+#define CPPMATH_OPTIMIZATION_SIMPLEXSTATISTICS_HPP_
+
+#include <chrono>
+#include <cstddef> // size_t
+#include <vector>
+
+namespace cppmath
+{
+    /**
+     * Statistics of a Downhill Simplex optimization: evaluations, finished steps, time of the objective function versus
+     * the algorithm and the best function value per iteration.
+     * Define CPPMATH_NO_STATISTICS to compile out the recording, all methods are empty then.
+     *
+     * \author cpieloth
+     * \copyright Copyright 2015 Christof Pieloth, Licensed under the Apache License, Version 2.0
+     */
+    class SimplexStatistics
+    {
+    public:
+        typedef std::chrono::steady_clock::time_point TimePointT; /**< Abbreviation for a point in time. */
+
+        /**
+         * Step which has finished an iteration.
+         */
+        enum Step
+        {
+            STEP_REFLECTION, /**< Reflected point was accepted. */
+            STEP_EXPANSION, /**< Expansion was tried. */
+            STEP_CONTRACTION, /**< Contracted point was accepted. */
+            STEP_SHRINKAGE, /**< Simplex was shrunk. */
+            STEP_COUNT /**< Number of steps. */
+        };
+
+        /**
+         * Indicates if the statistics are recorded, i.e. CPPMATH_NO_STATISTICS is not defined.
+         */
+#ifdef CPPMATH_NO_STATISTICS
+        static const bool ENABLED = false;
+#else
+        static const bool ENABLED = true;
+#endif
+
+        SimplexStatistics();
+        virtual ~SimplexStatistics();
+
+        /**
+         * Returns the current time, if the statistics are enabled.
+         *
+         * \return Current time or a constant.
+         */
+        static TimePointT now();
+
+        /**
+         * Resets all values and starts the clock for the total time.
+         */
+        void start();
+
+        /**
+         * Stops the clock for the total time.
+         */
+        void stop();
+
+        /**
+         * Counts evaluations and their time.
+         *
+         * \param evaluations Number of evaluated points.
+         * \param start Start time of the evaluation, see now().
+         */
+        void addEvaluations( size_t evaluations, const TimePointT& start );
+
+        /**
+         * Counts a finished step.
+         *
+         * \param step Step which has finished the iteration.
+         */
+        void addStep( Step step );
+
+        /**
+         * Appends the best function value of an iteration to the trajectory.
+         *
+         * \param f Best function value.
+         */
+        void addBest( double f );
+
+        size_t getEvaluations() const;
+
+        size_t getSteps( Step step ) const;
+
+        /**
+         * Returns the time spent in func() and funcBatch().
+         *
+         * \return Seconds.
+         */
+        double getObjectiveSeconds() const;
+
+        /**
+         * Returns the time of the whole optimization.
+         *
+         * \return Seconds.
+         */
+        double getTotalSeconds() const;
+
+        /**
+         * Returns the time spent in the algorithm, i.e. total time without objective time.
+         *
+         * \return Seconds.
+         */
+        double getOverheadSeconds() const;
+
+        /**
+         * Returns the best function value of each iteration.
+         *
+         * \return Best function values.
+         */
+        const std::vector< double >& getTrajectory() const;
+
+    private:
+        size_t m_evaluations;
+        size_t m_steps[STEP_COUNT];
+        double m_objectiveSeconds;
+        double m_totalSeconds;
+        TimePointT m_start;
+        std::vector< double > m_trajectory;
+    };
+} /* namespace cppmath */
+
+// Load the implementation
+#include "SimplexStatistics-impl.hpp"
+
+#endif  // CPPMATH_OPTIMIZATION_SIMPLEXSTATISTICS_HPP_
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <string>
 
+#include <cppmath/optimization/DownhillSimplexMultiStart.hpp>
+
 #include "ParabolicValley.hpp"
 #include "QuarticFunction.hpp"
 #include "BealesFunction.hpp"
@@ -36,5 +38,19 @@ int main()
     std::cout << tab << tab << qf.getResultError() << "/" << qf.getEpsilon() << " epsilon" << std::endl;
     std::cout << tab << tab << "Result: " << qf.getResultParams() << std::endl;
 
+    std::cout << std::endl;
+
+    std::cout << tab << "Beale's Function (multi-start):" << std::endl;
+    cppmath::DownhillSimplexMultiStart< BealesFunction > ms( bf );
+    cppmath::DownhillSimplexMultiStart< BealesFunction >::ParamsListT initials;
+    for( size_t i = 0; i < 64; ++i )
+    {
+        initials.push_back( 5.0 * BealesFunction::ParamsT::Random() );
+    }
+    ms.optimize( initials );
+    std::cout << tab << tab << "Best start: " << ms.getResultIndex() << "/" << initials.size() << std::endl;
+    std::cout << tab << tab << ms.getResultError() << "/" << bf.getEpsilon() << " epsilon" << std::endl;
+    std::cout << tab << tab << "Result: " << ms.getResultParams() << std::endl;
+
     return 0;
 }
@@ -0,0 +1,78 @@
+#ifndef MATTESTFILE_HPP_
+#define MATTESTFILE_HPP_
+
+#include <cstdio> // remove()
+#include <cstdlib> // getenv(), mkstemps()
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h> // close()
+
+#include <cppmath/matlab/io.hpp>
+
+/**
+ * Temporary MAT-file for the test suites. Each instance reserves an unique file in the temp directory,
+ * so the suites neither depend on the working directory nor overwrite each others files.
+ */
+class MatTestFile
+{
+public:
+    MatTestFile()
+    {
+        const char* const tmpDir = std::getenv( "TMPDIR" );
+        const std::string pattern = std::string( tmpDir != NULL ? tmpDir : "/tmp" ) + "/cppmath_XXXXXX.mat";
+        std::vector< char > path( pattern.begin(), pattern.end() );
+        path.push_back( '\0' );
+        const int fd = mkstemps( path.data(), 4 );
+        if( fd != -1 )
+        {
+            close( fd );
+            m_fileName = path.data();
+        }
+    }
+
+    ~MatTestFile()
+    {
+        remove();
+    }
+
+    /**
+     * Returns the unique file name, which is empty if the file could not be reserved.
+     *
+     * \return Path of the temporary file.
+     */
+    const std::string& getFileName() const
+    {
+        return m_fileName;
+    }
+
+    /**
+     * Truncates the file and writes the MAT-file header. Matrices can be appended to the stream.
+     *
+     * \param ofs Stream to open.
+     * \param description Description text for header.
+     * \return true, if successful.
+     */
+    bool create( std::ofstream* const ofs, const std::string& description ) const
+    {
+        ofs->open( m_fileName.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+        return cppmath::matlab::MatWriter::writeHeader( *ofs, description );
+    }
+
+    void remove() const
+    {
+        if( !m_fileName.empty() )
+        {
+            std::remove( m_fileName.c_str() );
+        }
+    }
+
+private:
+    MatTestFile( const MatTestFile& );
+    MatTestFile& operator=( const MatTestFile& );
+
+    std::string m_fileName;
+};
+
+#endif  // MATTESTFILE_HPP_
@@ -0,0 +1,79 @@
+#ifndef TESTMATBUFFEREDWRITER_HPP_
+#define TESTMATBUFFEREDWRITER_HPP_
+
+#include <string>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+
+#include <cppmath/matlab/MatBufferedWriter.hpp>
+#include <cppmath/matlab/MatFile.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatBufferedWriter: public CxxTest::TestSuite
+{
+public:
+    void tearDown()
+    {
+        m_file.remove();
+    }
+
+    void test_open()
+    {
+        cppmath::matlab::MatBufferedWriter writer;
+        TS_ASSERT( !writer.isOpen() );
+        TS_ASSERT( !writer.open( "no_such_dir/file.mat", "TestMatBufferedWriter" ) );
+        TS_ASSERT( writer.getError() != 0 );
+        TS_ASSERT( !writer.writeMatrixDouble( Eigen::MatrixXd::Ones( 2, 2 ), "a" ) );
+
+        TS_ASSERT( writer.open( m_file.getFileName(), "TestMatBufferedWriter" ) );
+        TS_ASSERT_EQUALS( writer.getError(), 0 );
+        TS_ASSERT_EQUALS( writer.getBufferedBytes(), 128 );
+        TS_ASSERT( writer.close() );
+        TS_ASSERT_EQUALS( writer.getWrittenBytes(), 128 );
+
+        cppmath::matlab::MatFile file;
+        TS_ASSERT( file.open( m_file.getFileName() ) );
+        TS_ASSERT_EQUALS( file.getFileInfo().description, "TestMatBufferedWriter" );
+        TS_ASSERT( file.getElements().empty() );
+    }
+
+    void test_writeMatrixDouble()
+    {
+        const Eigen::MatrixXd small = Eigen::MatrixXd::Random( 3, 2 );
+        const Eigen::MatrixXd large = Eigen::MatrixXd::Random( 40, 30 );
+
+        // Small buffer to write both, collected and directly written data
+        cppmath::matlab::MatBufferedWriter writer( 512 );
+        TS_ASSERT( writer.open( m_file.getFileName(), "TestMatBufferedWriter" ) );
+        for( int i = 0; i < 20; ++i )
+        {
+            TS_ASSERT( writer.writeMatrixDouble( small * i, "small" + std::to_string( i ) ) );
+        }
+        TS_ASSERT( writer.writeMatrixDouble( large, "large" ) );
+        TS_ASSERT( writer.writeMatrixDouble( small, "s" ) );
+        TS_ASSERT_LESS_THAN( 0, writer.getBufferedBytes() );
+        TS_ASSERT( writer.close() );
+        TS_ASSERT_EQUALS( writer.getBufferedBytes(), 0 );
+
+        cppmath::matlab::MatFile file;
+        TS_ASSERT( file.open( m_file.getFileName() ) );
+        TS_ASSERT_EQUALS( file.getFileInfo().fileSize, writer.getWrittenBytes() );
+        TS_ASSERT_EQUALS( file.getElements().size(), 22 );
+
+        Eigen::MatrixXd matrix;
+        TS_ASSERT( file.load( &matrix, "small7" ) );
+        TS_ASSERT( matrix == small * 7 );
+        TS_ASSERT( file.load( &matrix, "large" ) );
+        TS_ASSERT( matrix == large );
+        TS_ASSERT( file.load( &matrix, "s" ) );
+        TS_ASSERT( matrix == small );
+    }
+
+private:
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATBUFFEREDWRITER_HPP_
@@ -0,0 +1,95 @@
+#ifndef TESTMATCOLUMNREADER_HPP_
+#define TESTMATCOLUMNREADER_HPP_
+
+#include <fstream>
+#include <list>
+#include <string>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+
+#include <cppmath/matlab/io.hpp>
+#include <cppmath/matlab/MatColumnReader.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatColumnReader: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 50, 37 );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatColumnReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "a" );
+        cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_a, "compressed" );
+        ofs.close();
+
+        m_ifs.open( m_file.getFileName().c_str(), std::ifstream::in | std::ifstream::binary );
+        TS_ASSERT( cppmath::matlab::MatReader::readHeader( &m_info, m_ifs ) );
+        TS_ASSERT( cppmath::matlab::MatReader::retrieveDataElements( &m_elements, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( m_elements.size(), 2 );
+    }
+
+    void tearDown()
+    {
+        m_ifs.close();
+        m_elements.clear();
+        m_file.remove();
+    }
+
+    void test_read()
+    {
+        cppmath::matlab::MatColumnReader reader;
+        cppmath::matlab::MatColumnReader compressed;
+        TS_ASSERT( !reader.isOpen() );
+        TS_ASSERT( reader.open( m_elements.front(), m_ifs, m_info ) );
+        TS_ASSERT( compressed.open( m_elements.back(), m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( reader.getRows(), m_a.rows() );
+        TS_ASSERT_EQUALS( reader.getCols(), m_a.cols() );
+
+        // Both readers share the stream
+        Eigen::MatrixXd block( m_a.rows(), 8 );
+        size_t columns = 0;
+        while( reader.getRemainingColumns() > 0 )
+        {
+            const size_t column = reader.getColumn();
+            TS_ASSERT( reader.read( &block, &columns ) );
+            TS_ASSERT( block.leftCols( columns ) == m_a.middleCols( column, columns ) );
+
+            TS_ASSERT( compressed.read( &block, &columns ) );
+            TS_ASSERT( block.leftCols( columns ) == m_a.middleCols( column, columns ) );
+        }
+        TS_ASSERT_EQUALS( columns, 37 % 8 );
+        TS_ASSERT_EQUALS( compressed.getRemainingColumns(), 0 );
+        TS_ASSERT( !reader.read( block.data(), 1 ) );
+    }
+
+    void test_skip()
+    {
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it;
+        for( it = m_elements.begin(); it != m_elements.end(); ++it )
+        {
+            cppmath::matlab::MatColumnReader reader;
+            TS_ASSERT( reader.open( *it, m_ifs, m_info ) );
+            TS_ASSERT( reader.skip( 30 ) );
+            TS_ASSERT( !reader.skip( 8 ) );
+
+            Eigen::MatrixXd block( m_a.rows(), 5 );
+            TS_ASSERT( reader.read( block.data(), 5 ) );
+            TS_ASSERT( block == m_a.middleCols( 30, 5 ) );
+            TS_ASSERT_EQUALS( reader.getRemainingColumns(), 2 );
+        }
+    }
+
+private:
+    Eigen::MatrixXd m_a;
+    std::ifstream m_ifs;
+    cppmath::matlab::FileInfo m_info;
+    std::list< cppmath::matlab::ElementInfo > m_elements;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATCOLUMNREADER_HPP_
@@ -0,0 +1,74 @@
+#ifndef TESTMATCOLUMNWRITER_HPP_
+#define TESTMATCOLUMNWRITER_HPP_
+
+#include <fstream>
+#include <string>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+
+#include <cppmath/matlab/io.hpp>
+#include <cppmath/matlab/MatColumnWriter.hpp>
+#include <cppmath/matlab/MatFile.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatColumnWriter: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 6, 25 );
+    }
+
+    void tearDown()
+    {
+        m_file.remove();
+    }
+
+    void test_append()
+    {
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatColumnWriter" ) );
+
+        cppmath::matlab::MatColumnWriter writer;
+        TS_ASSERT( !writer.isOpen() );
+        TS_ASSERT( writer.open( ofs, m_a.rows(), "streamed" ) );
+        TS_ASSERT( writer.isOpen() );
+        TS_ASSERT( writer.append( m_a.leftCols( 10 ) ) );
+        TS_ASSERT( writer.append( m_a.data() + 10 * m_a.rows(), 1 ) );
+        TS_ASSERT( !writer.append( Eigen::MatrixXd::Zero( 2, 2 ) ) );
+        TS_ASSERT( writer.append( m_a.rightCols( 14 ) ) );
+        TS_ASSERT_EQUALS( writer.getCols(), m_a.cols() );
+        TS_ASSERT( writer.close() );
+        TS_ASSERT( !writer.isOpen() );
+
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a.transpose(), "after" );
+
+        // Closed by destructor
+        {
+            cppmath::matlab::MatColumnWriter tmp;
+            TS_ASSERT( tmp.open( ofs, 3, "last" ) );
+            TS_ASSERT( tmp.append( Eigen::MatrixXd::Ones( 3, 2 ) ) );
+        }
+        ofs.close();
+
+        cppmath::matlab::MatFile file;
+        TS_ASSERT( file.open( m_file.getFileName() ) );
+        TS_ASSERT_EQUALS( file.getElements().size(), 3 );
+        Eigen::MatrixXd matrix;
+        TS_ASSERT( file.load( &matrix, "streamed" ) );
+        TS_ASSERT( matrix == m_a );
+        TS_ASSERT( file.load( &matrix, "after" ) );
+        TS_ASSERT( matrix == m_a.transpose() );
+        TS_ASSERT( file.load( &matrix, "last" ) );
+        TS_ASSERT( matrix == Eigen::MatrixXd::Ones( 3, 2 ) );
+    }
+
+private:
+    Eigen::MatrixXd m_a;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATCOLUMNWRITER_HPP_
@@ -0,0 +1,85 @@
+#ifndef TESTMATFILE_HPP_
+#define TESTMATFILE_HPP_
+
+#include <fstream>
+#include <string>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+
+#include <cppmath/matlab/io.hpp>
+#include <cppmath/matlab/MatFile.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatFile: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 7, 3 );
+        m_b = Eigen::MatrixXd::Random( 2, 9 );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatFile" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "a" );
+        cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_b, "matrixB" );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_b, "c" );
+        ofs.close();
+    }
+
+    void tearDown()
+    {
+        m_file.remove();
+    }
+
+    void test_find()
+    {
+        cppmath::matlab::MatFile file;
+        TS_ASSERT( !file.isOpen() );
+        TS_ASSERT( !file.open( "no_such_file.mat" ) );
+        TS_ASSERT( file.open( m_file.getFileName() ) );
+        TS_ASSERT( file.isOpen() );
+        TS_ASSERT_EQUALS( file.getFileInfo().description, "TestMatFile" );
+
+        const cppmath::matlab::ElementInfo* element = file.find( "matrixB" );
+        TS_ASSERT( element != NULL );
+        TS_ASSERT_EQUALS( element->rows, m_b.rows() );
+        TS_ASSERT_EQUALS( element->cols, m_b.cols() );
+        TS_ASSERT_EQUALS( file.find( "a" )->rows, m_a.rows() );
+        TS_ASSERT( file.find( "unknown" ) == NULL );
+        TS_ASSERT_EQUALS( file.getElements().size(), 3 );
+        TS_ASSERT_EQUALS( file.find( "matrixB" ), element );
+
+        file.close();
+        TS_ASSERT( !file.isOpen() );
+        TS_ASSERT( file.find( "a" ) == NULL );
+    }
+
+    void test_load()
+    {
+        cppmath::matlab::MatFile file;
+        TS_ASSERT( file.open( m_file.getFileName() ) );
+
+        Eigen::MatrixXd matrix;
+        TS_ASSERT( file.load( &matrix, "c" ) );
+        TS_ASSERT( matrix == m_b );
+        TS_ASSERT( file.load( &matrix, "a" ) );
+        TS_ASSERT( matrix == m_a );
+        TS_ASSERT( file.load( &matrix, "matrixB" ) );
+        TS_ASSERT( matrix == m_b );
+        TS_ASSERT( !file.load( &matrix, "unknown" ) );
+
+        TS_ASSERT( file.loadBlock( &matrix, "a", 2, 1, 3, 2 ) );
+        TS_ASSERT( matrix == m_a.block( 2, 1, 3, 2 ) );
+        TS_ASSERT( !file.loadBlock( &matrix, "a", 2, 1, 3, 3 ) );
+    }
+
+private:
+    Eigen::MatrixXd m_a;
+    Eigen::MatrixXd m_b;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATFILE_HPP_
@@ -0,0 +1,107 @@
+#ifndef TESTMATINDEX_HPP_
+#define TESTMATINDEX_HPP_
+
+#include <cstdio> // remove()
+#include <fstream>
+#include <string>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+
+#include <cppmath/matlab/io.hpp>
+#include <cppmath/matlab/MatIndex.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatIndex: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 7, 3 );
+        write( 2 );
+    }
+
+    void tearDown()
+    {
+        m_file.remove();
+        std::remove( cppmath::matlab::MatIndex::getIndexFileName( m_file.getFileName() ).c_str() );
+    }
+
+    void test_open()
+    {
+        std::ifstream ifs;
+        cppmath::matlab::FileInfo info;
+        cppmath::matlab::MatIndex index;
+        TS_ASSERT( !index.load( m_file.getFileName() ) );
+
+        // Creates the index
+        open( &ifs, &info );
+        TS_ASSERT( index.open( m_file.getFileName(), ifs, info ) );
+        TS_ASSERT_EQUALS( index.getElements().size(), 2 );
+        TS_ASSERT( index.find( "unknown" ) == NULL );
+
+        // Loads the index
+        cppmath::matlab::MatIndex loaded;
+        TS_ASSERT( loaded.load( m_file.getFileName() ) );
+        TS_ASSERT_EQUALS( loaded.getElements().size(), 2 );
+
+        const cppmath::matlab::ElementInfo* element = loaded.find( "matrix1" );
+        TS_ASSERT( element != NULL );
+        TS_ASSERT_EQUALS( element->arrayName, "matrix1" );
+        TS_ASSERT_EQUALS( element->rows, m_a.rows() );
+        TS_ASSERT_EQUALS( element->cols, m_a.cols() );
+        TS_ASSERT( element->dims == index.find( "matrix1" )->dims );
+        TS_ASSERT_EQUALS( element->posData, index.find( "matrix1" )->posData );
+
+        Eigen::MatrixXd matrix;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixDouble( &matrix, *element, ifs, info ) );
+        TS_ASSERT( matrix == m_a );
+    }
+
+    void test_outdated()
+    {
+        std::ifstream ifs;
+        cppmath::matlab::FileInfo info;
+        cppmath::matlab::MatIndex index;
+        open( &ifs, &info );
+        TS_ASSERT( index.open( m_file.getFileName(), ifs, info ) );
+        TS_ASSERT( index.load( m_file.getFileName() ) );
+
+        // Changed file invalidates the index
+        ifs.close();
+        write( 3 );
+        TS_ASSERT( !index.load( m_file.getFileName() ) );
+        TS_ASSERT( index.getElements().empty() );
+
+        open( &ifs, &info );
+        TS_ASSERT( index.open( m_file.getFileName(), ifs, info ) );
+        TS_ASSERT_EQUALS( index.getElements().size(), 3 );
+        TS_ASSERT( index.load( m_file.getFileName() ) );
+        TS_ASSERT( index.find( "matrix2" ) != NULL );
+    }
+
+private:
+    void write( size_t count )
+    {
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatIndex" ) );
+        for( size_t i = 0; i < count; ++i )
+        {
+            cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "matrix" + std::to_string( i ) );
+        }
+        ofs.close();
+    }
+
+    void open( std::ifstream* const ifs, cppmath::matlab::FileInfo* const info )
+    {
+        ifs->open( m_file.getFileName().c_str(), std::ifstream::in | std::ifstream::binary );
+        TS_ASSERT( cppmath::matlab::MatReader::readHeader( info, *ifs ) );
+    }
+
+    Eigen::MatrixXd m_a;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATINDEX_HPP_
@@ -0,0 +1,202 @@
+#ifndef TESTMATMAPPEDREADER_HPP_
+#define TESTMATMAPPEDREADER_HPP_
+
+#include <fstream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+#include <cppmath/matlab/io.hpp>
+#include <cppmath/matlab/MatMappedReader.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatMappedReader: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 7, 3 );
+        m_b = Eigen::MatrixXd::Random( 1, 5 );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatMappedReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "matrixA" );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_b, "b" );
+        ofs.close();
+    }
+
+    void tearDown()
+    {
+        m_file.remove();
+    }
+
+    void test_open()
+    {
+        cppmath::matlab::MatMappedReader reader;
+        TS_ASSERT( !reader.isOpen() );
+        TS_ASSERT( !reader.open( "no_such_file.mat" ) );
+        TS_ASSERT( !reader.isOpen() );
+
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        TS_ASSERT( reader.isOpen() );
+        TS_ASSERT( reader.getFileInfo().isMatFile );
+        TS_ASSERT_EQUALS( reader.getFileInfo().description, "TestMatMappedReader" );
+
+        reader.close();
+        TS_ASSERT( !reader.isOpen() );
+    }
+
+    void test_mapMatrixDouble()
+    {
+        cppmath::matlab::MatMappedReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        TS_ASSERT_EQUALS( elements.size(), 2 );
+        TS_ASSERT_EQUALS( elements.front().arrayName, "matrixA" );
+        TS_ASSERT_EQUALS( elements.back().arrayName, "b" );
+
+        cppmath::matlab::MatMappedReader::MatrixDoubleMapT a( NULL, 0, 0 );
+        TS_ASSERT( reader.mapMatrixDouble( &a, elements.front() ) );
+        TS_ASSERT_EQUALS( a.rows(), m_a.rows() );
+        TS_ASSERT_EQUALS( a.cols(), m_a.cols() );
+        TS_ASSERT( a == m_a );
+
+        cppmath::matlab::MatMappedReader::MatrixDoubleMapT b( NULL, 0, 0 );
+        TS_ASSERT( reader.mapMatrixDouble( &b, elements.back() ) );
+        TS_ASSERT( b == m_b );
+    }
+
+    void test_retrieveCompressed()
+    {
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatMappedReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_b, "b" );
+        cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_a, "compressed" );
+        ofs.close();
+
+        cppmath::matlab::MatMappedReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        TS_ASSERT_EQUALS( elements.size(), 2 );
+        const cppmath::matlab::ElementInfo& element = elements.back();
+        TS_ASSERT_EQUALS( element.dataType, cppmath::matlab::DataTypes::miCOMPRESSED );
+        TS_ASSERT_EQUALS( element.arrayName, "compressed" );
+        TS_ASSERT_EQUALS( element.rows, m_a.rows() );
+        TS_ASSERT_EQUALS( element.cols, m_a.cols() );
+
+        cppmath::matlab::MatMappedReader::MatrixDoubleMapT map( NULL, 0, 0 );
+        TS_ASSERT( !reader.mapMatrixDouble( &map, element ) );
+
+        // Compressed elements are read with MatReader
+        std::ifstream ifs( m_file.getFileName().c_str(), std::ifstream::in | std::ifstream::binary );
+        Eigen::MatrixXd matrix;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixDouble( &matrix, element, ifs, reader.getFileInfo() ) );
+        TS_ASSERT( matrix == m_a );
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &matrix, 1, 1, 4, 2, element, ifs, reader.getFileInfo() ) );
+        TS_ASSERT( matrix == m_a.block( 1, 1, 4, 2 ) );
+    }
+
+    void test_corruptElement()
+    {
+        // Set the number of bytes of the array name of matrixA beyond the element and file end.
+        std::fstream fs( m_file.getFileName().c_str(), std::fstream::in | std::fstream::out | std::fstream::binary );
+        const cppmath::matlab::mNumBytes_t bytes = 0x10000;
+        fs.seekp( 128 + 8 + 16 + 16 + sizeof(cppmath::matlab::mDataType_t) );
+        fs.write( ( const char* )&bytes, sizeof(bytes) );
+        fs.close();
+
+        cppmath::matlab::MatMappedReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        TS_ASSERT_EQUALS( elements.size(), 1 );
+        TS_ASSERT_EQUALS( elements.front().arrayName, "b" );
+    }
+
+    void test_mapMatrixSparse()
+    {
+        Eigen::SparseMatrix< double > s( 20, 30 );
+        s.insert( 0, 0 ) = 1.0;
+        s.insert( 19, 0 ) = 2.0;
+        s.insert( 5, 17 ) = 3.0;
+        s.insert( 7, 29 ) = 4.0;
+        s.makeCompressed();
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatMappedReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixSparse( ofs, s, "s" );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "matrixA" );
+        ofs.close();
+
+        cppmath::matlab::MatMappedReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        TS_ASSERT_EQUALS( elements.size(), 2 );
+        TS_ASSERT_EQUALS( elements.front().nzmax, 4 );
+
+        cppmath::matlab::MatMappedReader::SparseMatrixDoubleMapT sparse( 0, 0, 0, NULL, NULL, NULL );
+        TS_ASSERT( reader.mapMatrixSparse( &sparse, elements.front() ) );
+        TS_ASSERT_EQUALS( sparse.nonZeros(), 4 );
+        TS_ASSERT( Eigen::MatrixXd( sparse ) == Eigen::MatrixXd( s ) );
+        TS_ASSERT( !reader.mapMatrixSparse( &sparse, elements.back() ) );
+    }
+
+    void test_mapTensor()
+    {
+        Eigen::Tensor< double, 3 > t( 3, 4, 5 );
+        t.setRandom();
+        std::vector< cppmath::matlab::miINT32_t > dims;
+        dims.push_back( 3 );
+        dims.push_back( 4 );
+        dims.push_back( 5 );
+
+        std::ostringstream os;
+        cppmath::matlab::MatWriter::writeArraySubelements( os, cppmath::matlab::ArrayTypes::mxDOUBLE_CLASS, dims, "t" );
+        const size_t bytes = t.size() * sizeof(double);
+        cppmath::matlab::MatWriter::writeTagField( os, cppmath::matlab::DataTypes::miDOUBLE, bytes );
+        os.write( ( const char* )t.data(), bytes );
+        const std::string element = os.str();
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatMappedReader" ) );
+        cppmath::matlab::MatWriter::writeTagField( ofs, cppmath::matlab::DataTypes::miMATRIX, element.size() );
+        ofs.write( element.data(), element.size() );
+        ofs.close();
+
+        cppmath::matlab::MatMappedReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        TS_ASSERT_EQUALS( elements.size(), 1 );
+        TS_ASSERT( elements.front().dims == dims );
+
+        Eigen::TensorMap< const Eigen::Tensor< double, 3 > > tensor( NULL, 0, 0, 0 );
+        TS_ASSERT( reader.mapTensor( &tensor, elements.front() ) );
+        TS_ASSERT_EQUALS( tensor.dimension( 2 ), 5 );
+        TS_ASSERT_EQUALS( tensor( 2, 3, 4 ), t( 2, 3, 4 ) );
+        const Eigen::Tensor< double, 2 > slice = tensor.chip( 4, 2 );
+        TS_ASSERT_EQUALS( slice( 1, 2 ), t( 1, 2, 4 ) );
+
+        Eigen::TensorMap< const Eigen::Tensor< double, 2 > > matrix( NULL, 0, 0 );
+        TS_ASSERT( !reader.mapTensor( &matrix, elements.front() ) );
+    }
+
+private:
+    Eigen::MatrixXd m_a;
+    Eigen::MatrixXd m_b;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATMAPPEDREADER_HPP_
@@ -0,0 +1,139 @@
+#ifndef TESTMATPREADER_HPP_
+#define TESTMATPREADER_HPP_
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+
+#include <cppmath/concurrent/ThreadPool.hpp>
+#include <cppmath/matlab/io.hpp>
+#include <cppmath/matlab/MatPReader.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatPReader: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 7, 3 );
+        m_b = Eigen::MatrixXd::Random( 100, 20 );
+        m_c = Eigen::MatrixXcd::Random( 4, 5 );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatPReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "matrixA" );
+        cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_b, "b" );
+        cppmath::matlab::MatWriter::writeMatrixComplex( ofs, m_c, "complexC" );
+        ofs.close();
+    }
+
+    void tearDown()
+    {
+        m_file.remove();
+    }
+
+    void test_open()
+    {
+        cppmath::matlab::MatPReader reader;
+        TS_ASSERT( !reader.isOpen() );
+        TS_ASSERT( !reader.open( "no_such_file.mat" ) );
+        TS_ASSERT( !reader.isOpen() );
+
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        TS_ASSERT( reader.isOpen() );
+        TS_ASSERT( reader.getFileInfo().isMatFile );
+        TS_ASSERT_EQUALS( reader.getFileInfo().description, "TestMatPReader" );
+
+        reader.close();
+        TS_ASSERT( !reader.isOpen() );
+    }
+
+    void test_readMatrix()
+    {
+        cppmath::matlab::MatPReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        const cppmath::matlab::ElementInfo& elementA = *it++;
+        const cppmath::matlab::ElementInfo& elementB = *it++;
+        const cppmath::matlab::ElementInfo& elementC = *it++;
+        TS_ASSERT_EQUALS( elementA.arrayName, "matrixA" );
+        TS_ASSERT_EQUALS( elementB.arrayName, "b" );
+        TS_ASSERT_EQUALS( elementB.dataType, cppmath::matlab::DataTypes::miCOMPRESSED );
+        TS_ASSERT_EQUALS( elementC.arrayName, "complexC" );
+
+        Eigen::MatrixXd a;
+        TS_ASSERT( reader.readMatrixDouble( &a, elementA ) );
+        TS_ASSERT( a == m_a );
+        Eigen::MatrixXd b;
+        TS_ASSERT( reader.readMatrixDouble( &b, elementB ) );
+        TS_ASSERT( b == m_b );
+        Eigen::MatrixXf bf;
+        TS_ASSERT( reader.readMatrix( &bf, elementB ) );
+        TS_ASSERT( bf == m_b.cast< float >() );
+        Eigen::MatrixXcd c;
+        TS_ASSERT( reader.readMatrixComplex( &c, elementC ) );
+        TS_ASSERT( c == m_c );
+        TS_ASSERT( !reader.readMatrixComplex( &c, elementA ) );
+
+        Eigen::MatrixXd block;
+        TS_ASSERT( reader.readBlock( &block, 1, 1, 4, 2, elementA ) );
+        TS_ASSERT( block == m_a.block( 1, 1, 4, 2 ) );
+        TS_ASSERT( reader.readBlock( &block, 50, 10, 30, 5, elementB ) );
+        TS_ASSERT( block == m_b.block( 50, 10, 30, 5 ) );
+        TS_ASSERT( !reader.readBlock( &block, 0, 0, 8, 1, elementA ) );
+    }
+
+    void test_readConcurrent()
+    {
+        cppmath::matlab::MatPReader reader;
+        TS_ASSERT( reader.open( m_file.getFileName() ) );
+        std::list< cppmath::matlab::ElementInfo > elements;
+        TS_ASSERT( reader.retrieveDataElements( &elements ) );
+        const cppmath::matlab::ElementInfo& elementA = elements.front();
+        const cppmath::matlab::ElementInfo& elementB = *( ++elements.begin() );
+
+        // All threads read alternately from the same reader without locks.
+        const size_t reads = 64;
+        std::vector< Eigen::MatrixXd > matrices( reads );
+        std::atomic< size_t > next( 0 );
+        std::atomic< bool > allRead( true );
+        const std::function< void( size_t ) > worker = [&]( size_t )
+        {
+            for( size_t i = next++; i < reads; i = next++ )
+            {
+                if( !reader.readMatrixDouble( &matrices[i], i % 2 ? elementB : elementA ) )
+                {
+                    allRead = false;
+                }
+            }
+        };
+        cppmath::ThreadPool pool( 4 );
+        pool.parallelFor( 4, worker );
+
+        TS_ASSERT( allRead );
+        for( size_t i = 0; i < reads; ++i )
+        {
+            TS_ASSERT( matrices[i] == ( i % 2 ? m_b : m_a ) );
+        }
+    }
+
+private:
+    Eigen::MatrixXd m_a;
+    Eigen::MatrixXd m_b;
+    Eigen::MatrixXcd m_c;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATPREADER_HPP_
@@ -0,0 +1,524 @@
+#ifndef TESTMATREADER_HPP_
+#define TESTMATREADER_HPP_
+
+#include <algorithm> // reverse()
+#include <fstream>
+#include <sstream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+#include <cppmath/concurrent/ThreadPool.hpp>
+#include <cppmath/matlab/io.hpp>
+
+#include "MatTestFile.hpp"
+
+class TestMatReader: public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        m_a = Eigen::MatrixXd::Random( 7, 3 );
+        m_b = Eigen::MatrixXd::Zero( 100, 20 );
+        m_b.col( 3 ).setRandom();
+    }
+
+    void tearDown()
+    {
+        m_file.remove();
+    }
+
+    void test_readMatrixDouble()
+    {
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "matrixA" );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_b, "matrixB" );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "c" );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        TS_ASSERT_EQUALS( elements.front().dataType, cppmath::matlab::DataTypes::miMATRIX );
+
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        TS_ASSERT( readMatrix( *it++, "matrixA" ) == m_a );
+        TS_ASSERT( readMatrix( *it++, "matrixB" ) == m_b );
+        TS_ASSERT( readMatrix( *it++, "c" ) == m_a );
+    }
+
+    void test_readMatrixDoubleCompressed()
+    {
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        const size_t bytesA = cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_a, "matrixA" );
+        const size_t bytesB = cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_b, "matrixB", 9 );
+        const size_t bytesC = cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_a, "c", 1 );
+        ofs.close();
+        TS_ASSERT_LESS_THAN( bytesB, m_b.size() * sizeof(double) / 10 );
+        TS_ASSERT_LESS_THAN( 0, bytesA );
+        TS_ASSERT_LESS_THAN( 0, bytesC );
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        TS_ASSERT_EQUALS( elements.front().dataType, cppmath::matlab::DataTypes::miCOMPRESSED );
+        TS_ASSERT_EQUALS( elements.front().rows, m_a.rows() );
+        TS_ASSERT_EQUALS( elements.front().cols, m_a.cols() );
+
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        TS_ASSERT( readMatrix( *it++, "matrixA" ) == m_a );
+        TS_ASSERT( readMatrix( *it++, "matrixB" ) == m_b );
+        TS_ASSERT( readMatrix( *it++, "c" ) == m_a );
+    }
+
+    void test_readMatricesDouble()
+    {
+        std::vector< std::string > names;
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        for( size_t i = 0; i < 10; ++i )
+        {
+            names.push_back( "matrix" + std::to_string( i ) );
+            cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, m_a * i, names.back() );
+        }
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        std::reverse( names.begin(), names.end() );
+
+        cppmath::ThreadPool pool( 4 );
+        std::vector< Eigen::MatrixXd > matrices;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatricesDouble( &matrices, names, elements, m_file.getFileName(),
+                        m_info, &pool ) );
+        TS_ASSERT_EQUALS( matrices.size(), names.size() );
+        for( size_t i = 0; i < matrices.size(); ++i )
+        {
+            TS_ASSERT( matrices[i] == m_a * ( names.size() - 1 - i ) );
+        }
+
+        names.push_back( "unknown" );
+        TS_ASSERT( !cppmath::matlab::MatReader::readMatricesDouble( &matrices, names, elements, m_file.getFileName(),
+                        m_info ) );
+        TS_ASSERT_EQUALS( matrices.size(), names.size() );
+        TS_ASSERT( matrices.front() == m_a * 9 );
+
+        names.pop_back();
+        TS_ASSERT( !cppmath::matlab::MatReader::readMatricesDouble( &matrices, names, elements, "no_such_file.mat",
+                        m_info, &pool ) );
+    }
+
+    void test_readMatrixConverted()
+    {
+        const Eigen::Matrix< int16_t, Eigen::Dynamic, Eigen::Dynamic > a = ( m_a * 1000 ).cast< int16_t >();
+        const Eigen::Matrix< uint8_t, Eigen::Dynamic, Eigen::Dynamic > b = Eigen::Matrix< uint8_t, 1, 3 >( 1, 2, 255 );
+        const Eigen::MatrixXf c = m_b.cast< float >();
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        writeMatrix( ofs, a, cppmath::matlab::ArrayTypes::mxINT16_CLASS, cppmath::matlab::DataTypes::miINT16, "a" );
+        writeMatrix( ofs, b, cppmath::matlab::ArrayTypes::mxUINT8_CLASS, cppmath::matlab::DataTypes::miUINT8, "b" );
+        // double matrix stored as miSINGLE like MATLAB does to save space
+        writeMatrix( ofs, c, cppmath::matlab::ArrayTypes::mxDOUBLE_CLASS, cppmath::matlab::DataTypes::miSINGLE, "c" );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        const cppmath::matlab::ElementInfo& elementA = *it++;
+        const cppmath::matlab::ElementInfo& elementB = *it++;
+        const cppmath::matlab::ElementInfo& elementC = *it++;
+
+        TS_ASSERT( readMatrix( elementA, "a" ) == a.cast< double >() );
+        TS_ASSERT( readMatrix( elementB, "b" ) == b.cast< double >() );
+        TS_ASSERT( readMatrix( elementC, "c" ) == c.cast< double >() );
+
+        Eigen::MatrixXf matrixF;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrix( &matrixF, elementA, m_ifs, m_info ) );
+        TS_ASSERT( matrixF == a.cast< float >() );
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrix( &matrixF, elementC, m_ifs, m_info ) );
+        TS_ASSERT( matrixF == c );
+
+        Eigen::MatrixXi matrixI;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrix( &matrixI, elementA, m_ifs, m_info ) );
+        TS_ASSERT( matrixI == a.cast< int >() );
+        Eigen::Matrix< uint8_t, Eigen::Dynamic, Eigen::Dynamic > matrixU8;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrix( &matrixU8, elementB, m_ifs, m_info ) );
+        TS_ASSERT( matrixU8 == b );
+
+        std::ofstream ofsC;
+        TS_ASSERT( m_file.create( &ofsC, "TestMatReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofsC, m_a, "a" );
+        ofsC.close();
+        elements.clear();
+        readElements( &elements );
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrix( &matrixF, elements.front(), m_ifs, m_info ) );
+        TS_ASSERT( matrixF == m_a.cast< float >() );
+    }
+
+    void test_readMatrixBigEndian()
+    {
+        const Eigen::Matrix< int16_t, Eigen::Dynamic, Eigen::Dynamic > b = ( m_b * 1000 ).cast< int16_t >();
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        const char versionEndian[4] = { 0x01, 0x00, 'M', 'I' };
+        ofs.seekp( 124 );
+        ofs.write( versionEndian, 4 );
+        writeMatrixBigEndian( ofs, m_a, cppmath::matlab::ArrayTypes::mxDOUBLE_CLASS,
+                        cppmath::matlab::DataTypes::miDOUBLE, "a" );
+        writeMatrixBigEndian( ofs, b, cppmath::matlab::ArrayTypes::mxINT16_CLASS, cppmath::matlab::DataTypes::miINT16,
+                        "matrixB" );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT( !m_info.isLittleEndian );
+        TS_ASSERT_EQUALS( elements.size(), 2 );
+        TS_ASSERT_EQUALS( elements.front().rows, m_a.rows() );
+        TS_ASSERT_EQUALS( elements.front().cols, m_a.cols() );
+
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        TS_ASSERT( readMatrix( *it++, "a" ) == m_a );
+        TS_ASSERT( readMatrix( *it, "matrixB" ) == b.cast< double >() );
+
+        Eigen::Matrix< int16_t, Eigen::Dynamic, Eigen::Dynamic > matrixI16;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrix( &matrixI16, *it, m_ifs, m_info ) );
+        TS_ASSERT( matrixI16 == b );
+    }
+
+    void test_readBlock()
+    {
+        const Eigen::MatrixXd a = Eigen::MatrixXd::Random( 50, 300 );
+        const Eigen::Matrix< int16_t, Eigen::Dynamic, Eigen::Dynamic > b = ( a * 1000 ).cast< int16_t >();
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, a, "a" );
+        writeMatrix( ofs, b, cppmath::matlab::ArrayTypes::mxINT16_CLASS, cppmath::matlab::DataTypes::miINT16, "b" );
+        cppmath::matlab::MatWriter::writeMatrixDoubleCompressed( ofs, a, "c" );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        const cppmath::matlab::ElementInfo& elementA = *it++;
+        const cppmath::matlab::ElementInfo& elementB = *it++;
+        const cppmath::matlab::ElementInfo& elementC = *it++;
+
+        Eigen::MatrixXd block;
+        // Some rows of a column range
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &block, 10, 120, 5, 30, elementA, m_ifs, m_info ) );
+        TS_ASSERT( block == a.block( 10, 120, 5, 30 ) );
+        // All rows, i.e. contiguous columns
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &block, 0, 299, 50, 1, elementA, m_ifs, m_info ) );
+        TS_ASSERT( block == a.rightCols( 1 ) );
+        // Single row
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &block, 49, 0, 1, 300, elementA, m_ifs, m_info ) );
+        TS_ASSERT( block == a.bottomRows( 1 ) );
+
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &block, 3, 7, 20, 100, elementB, m_ifs, m_info ) );
+        TS_ASSERT( block == b.block( 3, 7, 20, 100 ).cast< double >() );
+        Eigen::Matrix< int16_t, Eigen::Dynamic, Eigen::Dynamic > blockI16;
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &blockI16, 3, 7, 20, 100, elementB, m_ifs, m_info ) );
+        TS_ASSERT( blockI16 == b.block( 3, 7, 20, 100 ) );
+
+        TS_ASSERT( cppmath::matlab::MatReader::readBlock( &block, 10, 120, 5, 30, elementC, m_ifs, m_info ) );
+        TS_ASSERT( block == a.block( 10, 120, 5, 30 ) );
+
+        // Out of range
+        TS_ASSERT( !cppmath::matlab::MatReader::readBlock( &block, 10, 290, 5, 11, elementA, m_ifs, m_info ) );
+        TS_ASSERT( !cppmath::matlab::MatReader::readBlock( &block, 46, 0, 5, 1, elementC, m_ifs, m_info ) );
+        TS_ASSERT( readMatrix( elementA, "a" ) == a );
+    }
+
+    void test_readMatrixSparse()
+    {
+        Eigen::SparseMatrix< double > a( m_b.rows(), m_b.cols() );
+        a = m_b.sparseView();
+        Eigen::SparseMatrix< double > b( 1000, 2000 );
+        b.insert( 999, 0 ) = 1.5;
+        b.insert( 3, 1999 ) = -2.5;
+        const Eigen::SparseMatrix< double > empty( 3, 2 );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        TS_ASSERT_LESS_THAN( 0, cppmath::matlab::MatWriter::writeMatrixSparse( ofs, a, "a" ) );
+        // not compressed, has to be compressed on write
+        TS_ASSERT_LESS_THAN( 0, cppmath::matlab::MatWriter::writeMatrixSparse( ofs, b, "matrixB" ) );
+        TS_ASSERT_LESS_THAN( 0, cppmath::matlab::MatWriter::writeMatrixSparse( ofs, empty, "empty" ) );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        TS_ASSERT_EQUALS( it->nzmax, a.nonZeros() );
+
+        Eigen::SparseMatrix< double > matrix;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixSparse( &matrix, *it, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( matrix.nonZeros(), a.nonZeros() );
+        TS_ASSERT( Eigen::MatrixXd( matrix ) == m_b );
+        Eigen::MatrixXd dense;
+        TS_ASSERT( !cppmath::matlab::MatReader::readMatrixDouble( &dense, *it++, m_ifs, m_info ) );
+
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixSparse( &matrix, *it++, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( matrix.nonZeros(), 2 );
+        TS_ASSERT_EQUALS( matrix.coeff( 999, 0 ), 1.5 );
+        TS_ASSERT_EQUALS( matrix.coeff( 3, 1999 ), -2.5 );
+
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixSparse( &matrix, *it, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( matrix.rows(), 3 );
+        TS_ASSERT_EQUALS( matrix.cols(), 2 );
+        TS_ASSERT_EQUALS( matrix.nonZeros(), 0 );
+    }
+
+    void test_writeMatrixSparseLimit()
+    {
+        // 2^29 values need 4 GiB, which exceeds the element size. The storage is allocated, but never touched.
+        const Eigen::Index nnz = Eigen::Index( 1 ) << 29;
+        Eigen::SparseMatrix< double > s( 1, 1 );
+        s.resizeNonZeros( nnz );
+        s.outerIndexPtr()[1] = nnz;
+        TS_ASSERT_EQUALS( s.nonZeros(), nnz );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        const std::streampos pos = ofs.tellp();
+        TS_ASSERT_EQUALS( cppmath::matlab::MatWriter::writeMatrixSparse( ofs, s, "s" ), 0 );
+        TS_ASSERT_EQUALS( ofs.tellp(), pos );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT( elements.empty() );
+    }
+
+    void test_readMatrixComplex()
+    {
+        const Eigen::MatrixXcd a = Eigen::MatrixXcd::Random( 7, 3 );
+        // More values than one chunk
+        const Eigen::MatrixXcd b = Eigen::MatrixXcd::Random( 100, 50 );
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        TS_ASSERT_LESS_THAN( 0, cppmath::matlab::MatWriter::writeMatrixComplex( ofs, a, "a" ) );
+        TS_ASSERT_LESS_THAN( 0, cppmath::matlab::MatWriter::writeMatrixComplex( ofs, b, "matrixB" ) );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "c" );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        const cppmath::matlab::ElementInfo& elementA = *it++;
+        const cppmath::matlab::ElementInfo& elementB = *it++;
+        const cppmath::matlab::ElementInfo& elementC = *it++;
+        TS_ASSERT( cppmath::matlab::ArrayFlags::isComplex( elementA.arrayFlags ) );
+
+        Eigen::MatrixXcd matrix;
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixComplex( &matrix, elementA, m_ifs, m_info ) );
+        TS_ASSERT( matrix == a );
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixComplex( &matrix, elementB, m_ifs, m_info ) );
+        TS_ASSERT( matrix == b );
+        TS_ASSERT( !cppmath::matlab::MatReader::readMatrixComplex( &matrix, elementC, m_ifs, m_info ) );
+    }
+
+    void test_readTensor()
+    {
+        Eigen::Tensor< double, 3 > a( 4, 3, 5 );
+        a.setRandom();
+        Eigen::Tensor< float, 4 > b( 2, 3, 1, 2 );
+        b.setRandom();
+
+        std::ofstream ofs;
+        TS_ASSERT( m_file.create( &ofs, "TestMatReader" ) );
+        writeTensor( ofs, a, cppmath::matlab::DataTypes::miDOUBLE, "a" );
+        writeTensor( ofs, b, cppmath::matlab::DataTypes::miSINGLE, "tensorB" );
+        cppmath::matlab::MatWriter::writeMatrixDouble( ofs, m_a, "c" );
+        ofs.close();
+
+        std::list< cppmath::matlab::ElementInfo > elements;
+        readElements( &elements );
+        TS_ASSERT_EQUALS( elements.size(), 3 );
+        std::list< cppmath::matlab::ElementInfo >::const_iterator it = elements.begin();
+        const cppmath::matlab::ElementInfo& elementA = *it++;
+        const cppmath::matlab::ElementInfo& elementB = *it++;
+        const cppmath::matlab::ElementInfo& elementC = *it++;
+        TS_ASSERT_EQUALS( elementA.dims.size(), 3 );
+        TS_ASSERT_EQUALS( elementA.dims[2], 5 );
+        TS_ASSERT_EQUALS( elementA.rows, 4 );
+        TS_ASSERT_EQUALS( elementA.cols, 15 );
+        TS_ASSERT_EQUALS( elementB.dims.size(), 4 );
+        TS_ASSERT_EQUALS( elementC.dims.size(), 2 );
+
+        Eigen::Tensor< double, 3 > tensorA;
+        TS_ASSERT( cppmath::matlab::MatReader::readTensor( &tensorA, elementA, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( tensorA.dimension( 2 ), 5 );
+        const Eigen::Tensor< bool, 0 > isEqualA = ( tensorA == a ).all();
+        TS_ASSERT( isEqualA() );
+
+        // Trailing singleton dimension and n-dim array as 2-dim matrix
+        Eigen::Tensor< double, 4 > tensorA4;
+        TS_ASSERT( cppmath::matlab::MatReader::readTensor( &tensorA4, elementA, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( tensorA4.dimension( 3 ), 1 );
+        Eigen::Tensor< double, 2 > tensorA2;
+        TS_ASSERT( !cppmath::matlab::MatReader::readTensor( &tensorA2, elementA, m_ifs, m_info ) );
+        const Eigen::MatrixXd matrixA = readMatrix( elementA, "a" );
+        TS_ASSERT_EQUALS( matrixA( 1, 3 * 2 + 1 ), a( 1, 1, 2 ) );
+
+        Eigen::Tensor< float, 4 > tensorB;
+        TS_ASSERT( cppmath::matlab::MatReader::readTensor( &tensorB, elementB, m_ifs, m_info ) );
+        const Eigen::Tensor< bool, 0 > isEqualB = ( tensorB == b ).all();
+        TS_ASSERT( isEqualB() );
+        const Eigen::Tensor< float, 3 > trial = tensorB.chip( 1, 3 );
+        TS_ASSERT_EQUALS( trial( 1, 2, 0 ), b( 1, 2, 0, 1 ) );
+
+        Eigen::Tensor< double, 2 > tensorC;
+        TS_ASSERT( cppmath::matlab::MatReader::readTensor( &tensorC, elementC, m_ifs, m_info ) );
+        TS_ASSERT_EQUALS( tensorC( 6, 2 ), m_a( 6, 2 ) );
+    }
+
+private:
+    /**
+     * Writes a n-dim array, which is not supported by MatWriter.
+     */
+    template< typename T, int N >
+    void writeTensor( std::ofstream& ofs, const Eigen::Tensor< T, N >& tensor, cppmath::matlab::mDataType_t dataType,
+                    const std::string& name )
+    {
+        std::vector< cppmath::matlab::miINT32_t > dims;
+        for( int i = 0; i < N; ++i )
+        {
+            dims.push_back( tensor.dimension( i ) );
+        }
+        const cppmath::matlab::mArrayType_t arrayType =
+                        dataType == cppmath::matlab::DataTypes::miSINGLE ? cppmath::matlab::ArrayTypes::mxSINGLE_CLASS :
+                                        cppmath::matlab::ArrayTypes::mxDOUBLE_CLASS;
+
+        std::ostringstream os;
+        cppmath::matlab::MatWriter::writeArraySubelements( os, arrayType, dims, name );
+        const cppmath::matlab::mNumBytes_t bytes = tensor.size() * sizeof(T);
+        cppmath::matlab::MatWriter::writeTagField( os, dataType, bytes );
+        os.write( ( const char* )tensor.data(), bytes );
+        cppmath::matlab::MatWriter::writePadding( os, bytes );
+
+        const std::string element = os.str();
+        cppmath::matlab::MatWriter::writeTagField( ofs, cppmath::matlab::DataTypes::miMATRIX, element.size() );
+        ofs.write( element.data(), element.size() );
+    }
+
+    /**
+     * Writes a matrix in big endian, all words and values are swapped.
+     */
+    template< typename T >
+    void writeMatrixBigEndian( std::ofstream& ofs, const Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >& matrix,
+                    cppmath::matlab::mArrayType_t arrayType, cppmath::matlab::mDataType_t dataType,
+                    const std::string& name )
+    {
+        std::vector< uint32_t > words;
+        words.push_back( cppmath::matlab::DataTypes::miUINT32 );
+        words.push_back( 8 );
+        words.push_back( arrayType );
+        words.push_back( 0 );
+        words.push_back( cppmath::matlab::DataTypes::miINT32 );
+        words.push_back( 8 );
+        words.push_back( matrix.rows() );
+        words.push_back( matrix.cols() );
+        cppmath::matlab::ByteOrder::swap( words.data(), words.size(), sizeof(uint32_t) );
+
+        std::string nameBytes = name;
+        nameBytes.resize( name.size() <= 4 ? 4 : ( name.size() + 7 ) / 8 * 8, '\0' );
+        uint32_t nameTag[2] = { cppmath::matlab::DataTypes::miINT8, static_cast< uint32_t >( name.size() ) };
+        if( name.size() <= 4 )
+        {
+            nameTag[0] |= name.size() << 16;
+        }
+        cppmath::matlab::ByteOrder::swap( nameTag, 2, sizeof(uint32_t) );
+
+        Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic > data = matrix;
+        cppmath::matlab::ByteOrder::swap( data.data(), data.size(), sizeof(T) );
+        const uint32_t dataBytes = data.size() * sizeof(T);
+        uint32_t dataTag[2] = { dataType, dataBytes };
+        cppmath::matlab::ByteOrder::swap( dataTag, 2, sizeof(uint32_t) );
+
+        std::ostringstream os;
+        os.write( ( const char* )words.data(), words.size() * sizeof(uint32_t) );
+        os.write( ( const char* )nameTag, name.size() <= 4 ? 4 : 8 );
+        os.write( nameBytes.data(), nameBytes.size() );
+        os.write( ( const char* )dataTag, sizeof( dataTag ) );
+        os.write( ( const char* )data.data(), dataBytes );
+        cppmath::matlab::MatWriter::writePadding( os, dataBytes );
+
+        const std::string element = os.str();
+        uint32_t tag[2] = { cppmath::matlab::DataTypes::miMATRIX, static_cast< uint32_t >( element.size() ) };
+        cppmath::matlab::ByteOrder::swap( tag, 2, sizeof(uint32_t) );
+        ofs.write( ( const char* )tag, sizeof( tag ) );
+        ofs.write( element.data(), element.size() );
+    }
+
+    /**
+     * Writes a matrix with the given storage type, which is not supported by MatWriter.
+     */
+    template< typename T >
+    void writeMatrix( std::ofstream& ofs, const Eigen::Matrix< T, Eigen::Dynamic, Eigen::Dynamic >& matrix,
+                    cppmath::matlab::mArrayType_t arrayType, cppmath::matlab::mDataType_t dataType,
+                    const std::string& name )
+    {
+        std::ostringstream os;
+        cppmath::matlab::MatWriter::writeArraySubelements( os, arrayType, matrix.rows(), matrix.cols(), name );
+        const cppmath::matlab::mNumBytes_t bytes = matrix.size() * sizeof(T);
+        if( bytes <= 4 )
+        {
+            // Small Data Element Format
+            const cppmath::matlab::mDataType_t tag = ( bytes << 16 ) | dataType;
+            char data[4] = { 0 };
+            std::copy( ( const char* )matrix.data(), ( const char* )matrix.data() + bytes, data );
+            os.write( ( const char* )&tag, sizeof( tag ) );
+            os.write( data, sizeof( data ) );
+        }
+        else
+        {
+            cppmath::matlab::MatWriter::writeTagField( os, dataType, bytes );
+            os.write( ( const char* )matrix.data(), bytes );
+            cppmath::matlab::MatWriter::writePadding( os, bytes );
+        }
+        const std::string element = os.str();
+        cppmath::matlab::MatWriter::writeTagField( ofs, cppmath::matlab::DataTypes::miMATRIX, element.size() );
+        ofs.write( element.data(), element.size() );
+    }
+
+    void readElements( std::list< cppmath::matlab::ElementInfo >* const elements )
+    {
+        m_ifs.close();
+        m_ifs.open( m_file.getFileName().c_str(), std::ifstream::in | std::ifstream::binary );
+        TS_ASSERT( cppmath::matlab::MatReader::readHeader( &m_info, m_ifs ) );
+        TS_ASSERT( cppmath::matlab::MatReader::retrieveDataElements( elements, m_ifs, m_info ) );
+    }
+
+    Eigen::MatrixXd readMatrix( const cppmath::matlab::ElementInfo& element, const std::string& name )
+    {
+        Eigen::MatrixXd matrix;
+        TS_ASSERT_EQUALS( element.arrayName, name );
+        TS_ASSERT( cppmath::matlab::MatReader::readMatrixDouble( &matrix, element, m_ifs, m_info ) );
+        return matrix;
+    }
+
+    Eigen::MatrixXd m_a;
+    Eigen::MatrixXd m_b;
+    std::ifstream m_ifs;
+    cppmath::matlab::FileInfo m_info;
+    MatTestFile m_file;
+};
+
+#endif  // TESTMATREADER_HPP_
@@ -0,0 +1,397 @@
+#ifndef TESTDOWNHILLSIMPLEXMETHOD_HPP_
+#define TESTDOWNHILLSIMPLEXMETHOD_HPP_
+
+#include <cmath>
+
+#include <cxxtest/TestSuite.h>
+
+#include <cppmath/concurrent/ThreadPool.hpp>
+#include <cppmath/optimization/DownhillSimplexMethod.hpp>
+#include <cppmath/optimization/EvaluationCache.hpp>
+
+/**
+ * Rosenbrock's valley, f(1, 1) = 0. Counts single and batch evaluations.
+ */
+class RosenbrockFunction: public cppmath::DownhillSimplexMethod< 2 >
+{
+public:
+    RosenbrockFunction() :
+                    m_batchCalls( 0 ), m_batchPoints( 0 )
+    {
+    }
+
+    virtual ~RosenbrockFunction()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+
+    virtual void funcBatch( Eigen::VectorXd* const values, const ParamsBatchT& points ) const;
+
+    mutable size_t m_batchCalls;
+    mutable size_t m_batchPoints;
+};
+
+inline
+double RosenbrockFunction::func( const ParamsT& x ) const
+{
+    const double x1 = x( 0 );
+    const double x2 = x( 1 );
+    return 100.0 * pow( ( x2 - pow( x1, 2 ) ), 2 ) + pow( x1 - 1.0, 2 );
+}
+
+inline
+void RosenbrockFunction::funcBatch( Eigen::VectorXd* const values, const ParamsBatchT& points ) const
+{
+    ++m_batchCalls;
+    m_batchPoints += points.cols();
+    const Eigen::ArrayXd x1 = points.row( 0 ).transpose().array();
+    const Eigen::ArrayXd x2 = points.row( 1 ).transpose().array();
+    *values = ( 100.0 * ( x2 - x1.square() ).square() + ( x1 - 1.0 ).square() ).matrix();
+}
+
+/**
+ * Sphere function, f(0, 0, 0, 0) = 0
+ */
+class SphereFunction: public cppmath::DownhillSimplexMethod< 4 >
+{
+public:
+    SphereFunction()
+    {
+    }
+
+    virtual ~SphereFunction()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+};
+
+inline
+double SphereFunction::func( const ParamsT& x ) const
+{
+    return x.squaredNorm();
+}
+
+/**
+ * Sphere function with a dimension given at runtime, f(0, ..., 0) = 0
+ */
+class SphereFunctionX: public cppmath::DownhillSimplexMethod< Eigen::Dynamic >
+{
+public:
+    explicit SphereFunctionX( size_t dimension ) :
+                    cppmath::DownhillSimplexMethod< Eigen::Dynamic >( dimension )
+    {
+    }
+
+    virtual ~SphereFunctionX()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+};
+
+inline
+double SphereFunctionX::func( const ParamsT& x ) const
+{
+    return x.squaredNorm();
+}
+
+/**
+ * Shifted sphere function with a non-zero minimum, f(1, 1, 1) = 5. Counts the evaluations.
+ */
+class ShiftedSphereFunction: public cppmath::DownhillSimplexMethod< 3 >
+{
+public:
+    ShiftedSphereFunction() :
+                    m_calls( 0 )
+    {
+    }
+
+    virtual ~ShiftedSphereFunction()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+
+    mutable size_t m_calls;
+};
+
+inline
+double ShiftedSphereFunction::func( const ParamsT& x ) const
+{
+    ++m_calls;
+    return ( x - ParamsT::Ones() ).squaredNorm() + 5.0;
+}
+
+/**
+ * Tests Downhill-Simplex-Method (Lagarias et al.).
+ */
+class TestDownhillSimplexMethod: public CxxTest::TestSuite
+{
+public:
+    void test_optimizeRosenbrock()
+    {
+        const RosenbrockFunction::ParamsT exp( 1.0, 1.0 );
+
+        RosenbrockFunction opt;
+        const RosenbrockFunction::ParamsT initial( -1.2, 1.0 );
+        opt.setEpsilon( 1e-10 );
+        opt.optimize( initial );
+
+        const RosenbrockFunction::ParamsT diff = opt.getResultParams() - exp;
+        TS_ASSERT_LESS_THAN( diff.squaredNorm(), 1e-6 );
+    }
+
+    void test_funcBatch()
+    {
+        RosenbrockFunction opt;
+        const RosenbrockFunction::ParamsT initial( -1.2, 1.0 );
+        opt.optimize( initial );
+
+        // createInitials() evaluates DIM+1 points at once, shrinkage() DIM points
+        TS_ASSERT_LESS_THAN_EQUALS( 1, opt.m_batchCalls );
+        TS_ASSERT_EQUALS( opt.m_batchPoints, 3 + ( opt.m_batchCalls - 1 ) * 2 );
+
+        RosenbrockFunction::ParamsBatchT points( 2, 3 );
+        points << -1.2, 1.0, 0.0, 1.0, 1.0, 0.0;
+        Eigen::VectorXd values;
+        opt.funcBatch( &values, points );
+        TS_ASSERT_EQUALS( values.size(), 3 );
+        for( Eigen::VectorXd::Index i = 0; i < points.cols(); ++i )
+        {
+            TS_ASSERT_DELTA( values( i ), opt.func( points.col( i ) ), 1e-12 );
+        }
+    }
+
+    void test_threadPool()
+    {
+        const SphereFunction::ParamsT initial( 3.0, -1.0, 0.0, 1.0 );
+
+        SphereFunction serial;
+        serial.optimize( initial );
+
+        cppmath::ThreadPool pool( 4 );
+        SphereFunction parallel;
+        parallel.setThreadPool( &pool );
+        TS_ASSERT_EQUALS( parallel.getThreadPool(), &pool );
+        parallel.optimize( initial );
+
+        TS_ASSERT_EQUALS( parallel.getResultIterations(), serial.getResultIterations() );
+        TS_ASSERT_EQUALS( parallel.getResultError(), serial.getResultError() );
+        TS_ASSERT_LESS_THAN( parallel.getResultError(), parallel.getEpsilon() );
+    }
+
+    void test_dynamicDimension()
+    {
+        const SphereFunction::ParamsT initial( 3.0, -1.0, 0.0, 1.0 );
+
+        SphereFunction fixed;
+        fixed.optimize( initial );
+
+        SphereFunctionX dynamic( 4 );
+        TS_ASSERT_EQUALS( dynamic.getMaximumIterations(), fixed.getMaximumIterations() );
+        const SphereFunctionX::ParamsT initialX = initial;
+        dynamic.optimize( initialX );
+
+        TS_ASSERT_EQUALS( dynamic.getResultParams().size(), 4 );
+        TS_ASSERT_EQUALS( dynamic.getResultIterations(), fixed.getResultIterations() );
+        TS_ASSERT_DELTA( dynamic.getResultError(), fixed.getResultError(), 1e-12 );
+
+        SphereFunctionX large( 10 );
+        large.setEpsilon( 1e-6 );
+        large.optimize( SphereFunctionX::ParamsT::Ones( 10 ) );
+        TS_ASSERT_LESS_THAN( large.getResultError(), 1e-6 );
+    }
+
+    void test_evaluations()
+    {
+        ShiftedSphereFunction opt;
+        opt.optimize( ShiftedSphereFunction::ParamsT( 3.0, -2.0, 4.0 ) );
+
+        // converged() must not evaluate the function again
+        TS_ASSERT_EQUALS( opt.getResultEvaluations(), opt.m_calls );
+        TS_ASSERT_LESS_THAN_EQUALS( opt.getResultIterations() + 4, opt.getResultEvaluations() );
+    }
+
+    void test_convergenceSpread()
+    {
+        ShiftedSphereFunction opt;
+        opt.getConvergence().setFunctionSpread( 1e-10 );
+        const ShiftedSphereFunction::Converged conv = opt.optimize( ShiftedSphereFunction::ParamsT( 3.0, -2.0, 4.0 ) );
+
+        TS_ASSERT_EQUALS( conv, ShiftedSphereFunction::CONVERGED_SPREAD );
+        TS_ASSERT_LESS_THAN( opt.getResultIterations(), opt.getMaximumIterations() );
+        TS_ASSERT_DELTA( opt.getResultError(), 5.0, 1e-6 );
+    }
+
+    void test_convergenceRelative()
+    {
+        ShiftedSphereFunction opt;
+        opt.getConvergence().setRelativeTolerance( 1e-12 );
+        const ShiftedSphereFunction::Converged conv = opt.optimize( ShiftedSphereFunction::ParamsT( 3.0, -2.0, 4.0 ) );
+
+        TS_ASSERT_EQUALS( conv, ShiftedSphereFunction::CONVERGED_RELATIVE );
+        TS_ASSERT_DELTA( opt.getResultError(), 5.0, 1e-6 );
+    }
+
+    void test_convergenceDiameter()
+    {
+        ShiftedSphereFunction opt;
+        opt.getConvergence().setDiameter( 1e-6 );
+        const ShiftedSphereFunction::Converged conv = opt.optimize( ShiftedSphereFunction::ParamsT( 3.0, -2.0, 4.0 ) );
+
+        TS_ASSERT_EQUALS( conv, ShiftedSphereFunction::CONVERGED_DIAMETER );
+        const ShiftedSphereFunction::ParamsT diff = opt.getResultParams() - ShiftedSphereFunction::ParamsT::Ones();
+        TS_ASSERT_LESS_THAN( diff.squaredNorm(), 1e-8 );
+    }
+
+    void test_convergenceBudget()
+    {
+        ShiftedSphereFunction opt;
+        opt.getConvergence().setEvaluationBudget( 20 );
+        TS_ASSERT_EQUALS( opt.optimize( ShiftedSphereFunction::ParamsT( 3.0, -2.0, 4.0 ) ),
+                        ShiftedSphereFunction::CONVERGED_EVALUATIONS );
+        TS_ASSERT_LESS_THAN_EQUALS( 20, opt.getResultEvaluations() );
+        TS_ASSERT_LESS_THAN( opt.getResultEvaluations(), 20 + 4 );
+
+        opt.getConvergence().setEvaluationBudget( 0 );
+        opt.getConvergence().setTimeBudget( 0.0 );
+        TS_ASSERT_EQUALS( opt.optimize( ShiftedSphereFunction::ParamsT( 3.0, -2.0, 4.0 ) ),
+                        ShiftedSphereFunction::CONVERGED_TIME );
+        TS_ASSERT_EQUALS( opt.getResultIterations(), 0 );
+    }
+
+    void test_cache()
+    {
+        const ShiftedSphereFunction::ParamsT initial( 3.0, -2.0, 4.0 );
+
+        ShiftedSphereFunction opt;
+        opt.getCache().setCapacity( 1024 );
+        opt.optimize( initial );
+        const size_t calls = opt.m_calls;
+        const ShiftedSphereFunction::ParamsT res = opt.getResultParams();
+        TS_ASSERT_EQUALS( opt.getResultEvaluations(), calls );
+        TS_ASSERT_EQUALS( opt.getCache().getMisses(), calls );
+
+        // Same path again, all values are cached
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.m_calls, calls );
+        TS_ASSERT_EQUALS( opt.getResultEvaluations(), 0 );
+        TS_ASSERT_EQUALS( opt.getCache().getMisses(), calls );
+        TS_ASSERT_LESS_THAN_EQUALS( calls, opt.getCache().getHits() );
+        const ShiftedSphereFunction::ParamsT diff = opt.getResultParams() - res;
+        TS_ASSERT_EQUALS( diff.squaredNorm(), 0.0 );
+    }
+
+    void test_cacheEviction()
+    {
+        cppmath::EvaluationCache cache( 2 );
+        const double x[3] = { 1.0, 2.0, 3.0 };
+        double f = 0.0;
+
+        cache.insert( &x[0], 1, 10.0 );
+        cache.insert( &x[1], 1, 20.0 );
+        TS_ASSERT( cache.lookup( &f, &x[0], 1 ) );
+        TS_ASSERT_EQUALS( f, 10.0 );
+
+        // x[1] is least recently used
+        cache.insert( &x[2], 1, 30.0 );
+        TS_ASSERT_EQUALS( cache.getSize(), 2 );
+        TS_ASSERT( !cache.lookup( &f, &x[1], 1 ) );
+        TS_ASSERT( cache.lookup( &f, &x[2], 1 ) );
+        TS_ASSERT_EQUALS( f, 30.0 );
+        TS_ASSERT_EQUALS( cache.getHits(), 2 );
+        TS_ASSERT_EQUALS( cache.getMisses(), 1 );
+
+        cache.setCapacity( 0 );
+        TS_ASSERT_EQUALS( cache.getSize(), 0 );
+        TS_ASSERT( !cache.lookup( &f, &x[2], 1 ) );
+    }
+
+    void test_cacheCopy()
+    {
+        const double x[3] = { 1.0, 2.0, 3.0 };
+        double f = 0.0;
+        cppmath::EvaluationCache* const source = new cppmath::EvaluationCache( 2 );
+        source->insert( &x[0], 1, 10.0 );
+        source->insert( &x[1], 1, 20.0 );
+
+        cppmath::EvaluationCache copy( *source );
+        cppmath::EvaluationCache assigned;
+        assigned = *source;
+        // The copies must not refer to the entries of the source.
+        delete source;
+
+        TS_ASSERT_EQUALS( copy.getSize(), 2 );
+        TS_ASSERT( copy.lookup( &f, &x[0], 1 ) );
+        TS_ASSERT_EQUALS( f, 10.0 );
+        TS_ASSERT( copy.lookup( &f, &x[1], 1 ) );
+        TS_ASSERT_EQUALS( f, 20.0 );
+        // LRU order is copied, x[0] is evicted
+        copy.insert( &x[2], 1, 30.0 );
+        TS_ASSERT( !copy.lookup( &f, &x[0], 1 ) );
+
+        TS_ASSERT_EQUALS( assigned.getCapacity(), 2 );
+        TS_ASSERT( assigned.lookup( &f, &x[0], 1 ) );
+        TS_ASSERT_EQUALS( f, 10.0 );
+        assigned.insert( &x[2], 1, 30.0 );
+        TS_ASSERT( !assigned.lookup( &f, &x[1], 1 ) );
+        TS_ASSERT( assigned.lookup( &f, &x[2], 1 ) );
+    }
+
+    void test_statistics()
+    {
+        RosenbrockFunction opt;
+        opt.optimize( RosenbrockFunction::ParamsT( -1.2, 1.0 ) );
+
+        const cppmath::SimplexStatistics& stats = opt.getStatistics();
+        if( !cppmath::SimplexStatistics::ENABLED )
+        {
+            TS_ASSERT_EQUALS( stats.getEvaluations(), 0 );
+            return;
+        }
+
+        TS_ASSERT_EQUALS( stats.getEvaluations(), opt.getResultEvaluations() );
+        size_t steps = 0;
+        for( size_t i = 0; i < cppmath::SimplexStatistics::STEP_COUNT; ++i )
+        {
+            steps += stats.getSteps( static_cast< cppmath::SimplexStatistics::Step >( i ) );
+        }
+        TS_ASSERT_EQUALS( steps, opt.getResultIterations() );
+        TS_ASSERT_LESS_THAN( 0, stats.getSteps( cppmath::SimplexStatistics::STEP_REFLECTION ) );
+
+        TS_ASSERT_LESS_THAN_EQUALS( stats.getObjectiveSeconds(), stats.getTotalSeconds() );
+        TS_ASSERT_LESS_THAN_EQUALS( 0.0, stats.getOverheadSeconds() );
+
+        const std::vector< double >& trajectory = stats.getTrajectory();
+        TS_ASSERT_EQUALS( trajectory.size(), opt.getResultIterations() + 1 );
+        for( size_t i = 1; i < trajectory.size(); ++i )
+        {
+            TS_ASSERT_LESS_THAN_EQUALS( trajectory[i], trajectory[i - 1] );
+        }
+        TS_ASSERT_EQUALS( trajectory.back(), opt.getResultError() );
+    }
+
+    void test_speculative()
+    {
+        const SphereFunction::ParamsT initial( 3.0, -1.0, 0.0, 1.0 );
+
+        SphereFunction sequential;
+        sequential.optimize( initial );
+
+        cppmath::ThreadPool pool( 4 );
+        SphereFunction speculative;
+        speculative.setThreadPool( &pool );
+        speculative.setSpeculative( true );
+        TS_ASSERT( speculative.isSpeculative() );
+        speculative.optimize( initial );
+
+        TS_ASSERT_EQUALS( speculative.getResultIterations(), sequential.getResultIterations() );
+        TS_ASSERT_EQUALS( speculative.getResultError(), sequential.getResultError() );
+        const SphereFunction::ParamsT diff = speculative.getResultParams() - sequential.getResultParams();
+        TS_ASSERT_LESS_THAN( diff.squaredNorm(), 1e-24 );
+    }
+};
+
+#endif  // TESTDOWNHILLSIMPLEXMETHOD_HPP_
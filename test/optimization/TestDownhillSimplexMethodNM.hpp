@@ -1,8 +1,12 @@
 #ifndef TESTDOWNHILLSIMPLEXMETHODNM_HPP_
 #define TESTDOWNHILLSIMPLEXMETHODNM_HPP_
 
+#include <cmath>
+#include <vector>
+
 #include <cxxtest/TestSuite.h>
 
+#include <cppmath/concurrent/ThreadPool.hpp>
 #include <cppmath/optimization/DownhillSimplexMethodNM.hpp>
 
 /**
@@ -88,6 +92,148 @@ double QuarticFunction::func( const ParamsT& x ) const
     return t1 + t2 + t3 + t4;
 }
 
+/**
+ * Sphere function, f(0, 0, 0, 0) = 0
+ */
+class SphereFunctionNM: public cppmath::DownhillSimplexMethodNM< 4 >
+{
+public:
+    SphereFunctionNM()
+    {
+    }
+
+    virtual ~SphereFunctionNM()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+};
+
+inline
+double SphereFunctionNM::func( const ParamsT& x ) const
+{
+    return x.squaredNorm();
+}
+
+/**
+ * Sphere function with a dimension given at runtime, f(0, ..., 0) = 0
+ */
+class SphereFunctionNMX: public cppmath::DownhillSimplexMethodNM< Eigen::Dynamic >
+{
+public:
+    explicit SphereFunctionNMX( size_t dimension ) :
+                    cppmath::DownhillSimplexMethodNM< Eigen::Dynamic >( dimension )
+    {
+    }
+
+    virtual ~SphereFunctionNMX()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+};
+
+inline
+double SphereFunctionNMX::func( const ParamsT& x ) const
+{
+    return x.squaredNorm();
+}
+
+/**
+ * Rosenbrock's valley, f(1, 1) = 0. Counts batch evaluations.
+ */
+class CountingValley: public cppmath::DownhillSimplexMethodNM< 2 >
+{
+public:
+    CountingValley() :
+                    m_batchCalls( 0 ), m_batchPoints( 0 )
+    {
+    }
+
+    virtual ~CountingValley()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+
+    virtual void funcBatch( Eigen::VectorXd* const values, const ParamsBatchT& points ) const;
+
+    mutable size_t m_batchCalls;
+    mutable size_t m_batchPoints;
+};
+
+inline
+double CountingValley::func( const ParamsT& x ) const
+{
+    const double x1 = x( 0 );
+    const double x2 = x( 1 );
+    return 100.0 * pow( ( x2 - pow( x1, 2 ) ), 2 ) + pow( x1 - 1.0, 2 );
+}
+
+inline
+void CountingValley::funcBatch( Eigen::VectorXd* const values, const ParamsBatchT& points ) const
+{
+    ++m_batchCalls;
+    m_batchPoints += points.cols();
+    cppmath::DownhillSimplexMethodNM< 2 >::funcBatch( values, points );
+}
+
+/**
+ * Shifted sphere function with a non-zero minimum, f(1, 1, 1) = 5. Counts the evaluations.
+ */
+class ShiftedSphereFunctionNM: public cppmath::DownhillSimplexMethodNM< 3 >
+{
+public:
+    ShiftedSphereFunctionNM() :
+                    m_calls( 0 )
+    {
+    }
+
+    virtual ~ShiftedSphereFunctionNM()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+
+    /**
+     * Checks that the indices are a permutation ordered by f(x) and that the values belong to the points.
+     */
+    bool isConsistent() const;
+
+    mutable size_t m_calls;
+};
+
+inline
+double ShiftedSphereFunctionNM::func( const ParamsT& x ) const
+{
+    ++m_calls;
+    return ( x - ParamsT::Ones() ).squaredNorm() + 5.0;
+}
+
+inline
+bool ShiftedSphereFunctionNM::isConsistent() const
+{
+    std::vector< bool > found( VALUES, false );
+    for( size_t i = 0; i < VALUES; ++i )
+    {
+        const int idx = m_idx( i );
+        if( idx < 0 || idx >= static_cast< int >( VALUES ) || found[idx] )
+        {
+            return false;
+        }
+        found[idx] = true;
+        if( i > 0 && m_f( m_idx( i - 1 ) ) > m_f( idx ) )
+        {
+            return false;
+        }
+        if( std::abs( m_f( idx ) - ( ( m_x.col( idx ) - ParamsT::Ones() ).squaredNorm() + 5.0 ) ) > 1e-12 )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Tests Downhill-Simplex-Method with some predefined functions.
  */
@@ -262,6 +408,189 @@ public:
         TS_ASSERT_LESS_THAN( opt.getResultIterations(), max_it );
     }
 
+    void test_funcBatch()
+    {
+        CountingValley opt;
+        opt.optimize( CountingValley::ParamsT( -1.2, 1.0 ) );
+
+        // createInitials() evaluates DIM+1 points at once, the shrinkage DIM points.
+        TS_ASSERT_LESS_THAN_EQUALS( 1, opt.m_batchCalls );
+        TS_ASSERT_EQUALS( opt.m_batchPoints, 3 + ( opt.m_batchCalls - 1 ) * 2 );
+
+        CountingValley::ParamsBatchT points( 2, 3 );
+        points << -1.2, 1.0, 0.0, 1.0, 1.0, 0.0;
+        Eigen::VectorXd values;
+        opt.funcBatch( &values, points );
+        TS_ASSERT_EQUALS( values.size(), 3 );
+        for( Eigen::VectorXd::Index i = 0; i < points.cols(); ++i )
+        {
+            TS_ASSERT_DELTA( values( i ), opt.func( points.col( i ) ), 1e-12 );
+        }
+    }
+
+    void test_shrinkage()
+    {
+        CountingValley opt;
+        opt.setEpsilon( 0.0 );
+        opt.setMaximumIterations( 500 );
+        opt.optimize( CountingValley::ParamsT( -1.2, 1.0 ) );
+
+        // The shrinkage keeps x_l, so only DIM new points are evaluated.
+        const size_t shrinks = opt.m_batchCalls - 1;
+        TS_ASSERT_LESS_THAN( 0, shrinks );
+        TS_ASSERT_EQUALS( opt.m_batchPoints, 3 + shrinks * 2 );
+        if( cppmath::SimplexStatistics::ENABLED )
+        {
+            TS_ASSERT_EQUALS( opt.getStatistics().getSteps( cppmath::SimplexStatistics::STEP_SHRINKAGE ), shrinks );
+        }
+        const CountingValley::ParamsT diff = opt.getResultParams() - CountingValley::ParamsT( 1.0, 1.0 );
+        TS_ASSERT_LESS_THAN( diff.squaredNorm(), 1e-12 );
+    }
+
+    void test_ordering()
+    {
+        // Ordered indices and incremental centroid must stay consistent over many iterations.
+        ShiftedSphereFunctionNM opt;
+        opt.setEpsilon( 0.0 );
+        for( size_t iterations = 1; iterations < 64; iterations += 7 )
+        {
+            opt.setMaximumIterations( iterations );
+            opt.optimize( ShiftedSphereFunctionNM::ParamsT( 3.0, -2.0, 4.0 ) );
+            TS_ASSERT_EQUALS( opt.getResultIterations(), iterations );
+            TS_ASSERT( opt.isConsistent() );
+        }
+
+        opt.setMaximumIterations( 2000 );
+        opt.optimize( ShiftedSphereFunctionNM::ParamsT( 3.0, -2.0, 4.0 ) );
+        TS_ASSERT( opt.isConsistent() );
+        const ShiftedSphereFunctionNM::ParamsT diff = opt.getResultParams() - ShiftedSphereFunctionNM::ParamsT::Ones();
+        TS_ASSERT_LESS_THAN( diff.squaredNorm(), 1e-12 );
+    }
+
+    void test_threadPool()
+    {
+        const SphereFunctionNM::ParamsT initial( 3.0, -1.0, 0.5, 1.0 );
+
+        SphereFunctionNM serial;
+        serial.optimize( initial );
+
+        cppmath::ThreadPool pool( 4 );
+        SphereFunctionNM parallel;
+        parallel.setThreadPool( &pool );
+        TS_ASSERT_EQUALS( parallel.getThreadPool(), &pool );
+        parallel.optimize( initial );
+
+        TS_ASSERT_EQUALS( parallel.getResultIterations(), serial.getResultIterations() );
+        TS_ASSERT_EQUALS( parallel.getResultError(), serial.getResultError() );
+    }
+
+    void test_dynamicDimension()
+    {
+        const SphereFunctionNM::ParamsT initial( 3.0, -1.0, 0.5, 1.0 );
+
+        SphereFunctionNM fixed;
+        fixed.optimize( initial );
+
+        SphereFunctionNMX dynamic( 4 );
+        TS_ASSERT_EQUALS( dynamic.getMaximumIterations(), fixed.getMaximumIterations() );
+        const SphereFunctionNMX::ParamsT initialX = initial;
+        dynamic.optimize( initialX );
+
+        TS_ASSERT_EQUALS( dynamic.getResultParams().size(), 4 );
+        TS_ASSERT_EQUALS( dynamic.getResultIterations(), fixed.getResultIterations() );
+        TS_ASSERT_DELTA( dynamic.getResultError(), fixed.getResultError(), 1e-12 );
+
+        SphereFunctionNMX large( 10 );
+        large.setEpsilon( 1e-6 );
+        large.setMaximumIterations( 5000 );
+        large.optimize( SphereFunctionNMX::ParamsT::Ones( 10 ) );
+        TS_ASSERT_LESS_THAN( large.getResultError(), 1e-6 );
+    }
+
+    void test_convergence()
+    {
+        const ShiftedSphereFunctionNM::ParamsT initial( 3.0, -2.0, 4.0 );
+
+        ShiftedSphereFunctionNM opt;
+        opt.setMaximumIterations( 5000 );
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.converged(), ShiftedSphereFunctionNM::CONVERGED_ITERATIONS );
+
+        opt.getConvergence().setFunctionSpread( 1e-10 );
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.converged(), ShiftedSphereFunctionNM::CONVERGED_SPREAD );
+        TS_ASSERT_LESS_THAN( opt.getResultIterations(), opt.getMaximumIterations() );
+        TS_ASSERT_DELTA( opt.getResultError(), 5.0, 1e-6 );
+
+        opt.setConvergence( cppmath::SimplexConvergence() );
+        opt.getConvergence().setDiameter( 1e-6 );
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.converged(), ShiftedSphereFunctionNM::CONVERGED_DIAMETER );
+
+        opt.setConvergence( cppmath::SimplexConvergence() );
+        opt.getConvergence().setEvaluationBudget( 20 );
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.converged(), ShiftedSphereFunctionNM::CONVERGED_EVALUATIONS );
+        TS_ASSERT_LESS_THAN_EQUALS( 20, opt.getResultEvaluations() );
+
+        opt.setConvergence( cppmath::SimplexConvergence() );
+        opt.getConvergence().setTimeBudget( 0.0 );
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.converged(), ShiftedSphereFunctionNM::CONVERGED_TIME );
+        TS_ASSERT_EQUALS( opt.getResultIterations(), 0 );
+    }
+
+    void test_cache()
+    {
+        const ShiftedSphereFunctionNM::ParamsT initial( 3.0, -2.0, 4.0 );
+
+        ShiftedSphereFunctionNM opt;
+        opt.getCache().setCapacity( 1024 );
+        opt.optimize( initial );
+        const size_t calls = opt.m_calls;
+        const ShiftedSphereFunctionNM::ParamsT res = opt.getResultParams();
+        TS_ASSERT_EQUALS( opt.getResultEvaluations(), calls );
+        TS_ASSERT_EQUALS( opt.getCache().getMisses(), calls );
+
+        // Same path again, all values are cached
+        opt.optimize( initial );
+        TS_ASSERT_EQUALS( opt.m_calls, calls );
+        TS_ASSERT_EQUALS( opt.getResultEvaluations(), 0 );
+        TS_ASSERT_LESS_THAN_EQUALS( calls, opt.getCache().getHits() );
+        const ShiftedSphereFunctionNM::ParamsT diff = opt.getResultParams() - res;
+        TS_ASSERT_EQUALS( diff.squaredNorm(), 0.0 );
+    }
+
+    void test_statistics()
+    {
+        ParabolicValley opt;
+        opt.optimize( ParabolicValley::ParamsT( -1.2, 1.0 ) );
+
+        const cppmath::SimplexStatistics& stats = opt.getStatistics();
+        if( !cppmath::SimplexStatistics::ENABLED )
+        {
+            TS_ASSERT_EQUALS( stats.getEvaluations(), 0 );
+            return;
+        }
+
+        TS_ASSERT_EQUALS( stats.getEvaluations(), opt.getResultEvaluations() );
+        size_t steps = 0;
+        for( size_t i = 0; i < cppmath::SimplexStatistics::STEP_COUNT; ++i )
+        {
+            steps += stats.getSteps( static_cast< cppmath::SimplexStatistics::Step >( i ) );
+        }
+        TS_ASSERT_EQUALS( steps, opt.getResultIterations() );
+        TS_ASSERT_LESS_THAN( 0, stats.getSteps( cppmath::SimplexStatistics::STEP_REFLECTION ) );
+        TS_ASSERT_LESS_THAN_EQUALS( stats.getObjectiveSeconds(), stats.getTotalSeconds() );
+
+        const std::vector< double >& trajectory = stats.getTrajectory();
+        TS_ASSERT_EQUALS( trajectory.size(), opt.getResultIterations() + 1 );
+        for( size_t i = 1; i < trajectory.size(); ++i )
+        {
+            TS_ASSERT_LESS_THAN_EQUALS( trajectory[i], trajectory[i - 1] );
+        }
+        TS_ASSERT_EQUALS( trajectory.back(), opt.getResultError() );
+    }
 };
 
 #endif  // TESTDOWNHILLSIMPLEXMETHODNM_HPP_
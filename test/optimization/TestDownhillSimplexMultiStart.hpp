@@ -0,0 +1,87 @@
+#ifndef TESTDOWNHILLSIMPLEXMULTISTART_HPP_
+#define TESTDOWNHILLSIMPLEXMULTISTART_HPP_
+
+#include <cmath>
+
+#include <cxxtest/TestSuite.h>
+
+#include <cppmath/concurrent/ThreadPool.hpp>
+#include <cppmath/optimization/DownhillSimplexMethod.hpp>
+#include <cppmath/optimization/DownhillSimplexMultiStart.hpp>
+
+/**
+ * Himmelblau's function, 4 local minima with f(x) = 0, e.g. f(3, 2) = 0
+ */
+class HimmelblausFunction: public cppmath::DownhillSimplexMethod< 2 >
+{
+public:
+    HimmelblausFunction()
+    {
+    }
+
+    virtual ~HimmelblausFunction()
+    {
+    }
+
+    virtual double func( const ParamsT& x ) const;
+};
+
+inline
+double HimmelblausFunction::func( const ParamsT& x ) const
+{
+    const double x1 = x( 0 );
+    const double x2 = x( 1 );
+    return pow( x1 * x1 + x2 - 11.0, 2 ) + pow( x1 + x2 * x2 - 7.0, 2 );
+}
+
+/**
+ * Tests the parallel multi-start of the Downhill-Simplex-Method.
+ */
+class TestDownhillSimplexMultiStart: public CxxTest::TestSuite
+{
+public:
+    void test_optimize()
+    {
+        HimmelblausFunction prototype;
+        prototype.setEpsilon( 1e-8 );
+        cppmath::DownhillSimplexMultiStart< HimmelblausFunction > opt( prototype );
+
+        cppmath::DownhillSimplexMultiStart< HimmelblausFunction >::ParamsListT initials;
+        for( size_t i = 0; i < 32; ++i )
+        {
+            initials.push_back( 5.0 * HimmelblausFunction::ParamsT::Random() );
+        }
+        cppmath::ThreadPool pool( 4 );
+        opt.setThreadPool( &pool );
+        opt.optimize( initials );
+
+        TS_ASSERT_EQUALS( opt.getResults().size(), initials.size() );
+        TS_ASSERT_LESS_THAN( opt.getResultError(), 1e-6 );
+        for( size_t i = 0; i < initials.size(); ++i )
+        {
+            const HimmelblausFunction::ParamsT diff = opt.getResults()[i].initial - initials[i];
+            TS_ASSERT_LESS_THAN( diff.squaredNorm(), 1e-12 );
+            TS_ASSERT_LESS_THAN_EQUALS( opt.getResultError(), opt.getResults()[i].error );
+        }
+    }
+
+    void test_optimizeSerial()
+    {
+        const HimmelblausFunction::ParamsT initial( 1.0, 1.0 );
+
+        HimmelblausFunction single;
+        single.optimize( initial );
+
+        cppmath::DownhillSimplexMultiStart< HimmelblausFunction > opt( single );
+        cppmath::DownhillSimplexMultiStart< HimmelblausFunction >::ParamsListT initials( 1, initial );
+        cppmath::ThreadPool pool( 1 );
+        opt.setThreadPool( &pool );
+        opt.optimize( initials );
+
+        TS_ASSERT_EQUALS( opt.getResultIndex(), 0 );
+        TS_ASSERT_EQUALS( opt.getResults()[0].iterations, single.getResultIterations() );
+        TS_ASSERT_DELTA( opt.getResultError(), single.getResultError(), 1e-12 );
+    }
+};
+
+#endif  // TESTDOWNHILLSIMPLEXMULTISTART_HPP_